@@ -3,6 +3,7 @@
 
 
 using namespace std;
+using namespace chrono;
 
 
 ////////////////////////////////////////////////////
@@ -75,6 +76,11 @@ int main(int argc, char** argv){
 
     log.set_log_style_colors(LOG_COLORS_BACKGROUND);
 
+    ///> set custom pattern (compiled once, "" returns to the modules above)
+    log.set_log_pattern("%Y-%m-%d %H:%M:%S.%e [%^%L%$] %t %@ %v");
+    LOG_MSG(LOG_INFO) << "custom pattern with thread id & call site";
+    log.set_log_pattern("");
+
 
     std::cout << "\n~~~~~~ PASS MSG & DATA ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n" << std::endl;
     ///> Everything that has a operator<< method for ostreams can be logged
@@ -94,6 +100,10 @@ int main(int argc, char** argv){
     log(LOG_ERR) << "log LOG_ERROR";
     log(LOG_TIME) << "log LOG_TIME";
 
+    ///> Same msgs, but compiled out when above CPP_UP_LOG_COMPILE_LEVEL
+    LOG_MSG(LOG_DEBUG) << "LOG_MSG LOG_DEBUG";
+    LOG_MSG(LOG_INFO) << "LOG_MSG LOG_INFO";
+
 
     std::cout << "\n~~~~~~ CHANGE LOG STATE TO DEFAULT ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n" << std::endl;
     ///> Change the log level
@@ -132,7 +142,8 @@ int main(int argc, char** argv){
 
     std::cout << "\n~~~~~~ LOG FILE ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n" << std::endl;
     ///> Log file
-    // log.set_log_file_path("/home/dev/Desktop/cpp_useful_pack");///> IN_PROGRESS
+    // log.set_log_file_rotation(10 << 20, hours(24), 5);  ///> rotate at 10MB or daily, keep 5 old files
+    // log.set_log_file_path("cpp_useful_pack.log");       ///> write to file as well (buffered, own I/O thread)
 
 
     std::cout << "\n~~~~~~ THREADS OVERLAPPING ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n" << std::endl;
@@ -141,6 +152,7 @@ int main(int argc, char** argv){
     *   WAS: $  [ D 2023-08-18; T 11:47:34 ][ D 2023-08-18; T 11:47:34 ][ WARNING ][ ERROR ]: : thread ONE ONE ONE ONE 1111 val
     *   NOW: $  [ D 2023-08-18; T 11:47:34 ][ WARNING ]: thread ONE ONE ONE ONE 1111 val
     *           [ D 2023-08-18; T 11:47:34 ][ ERROR   ]: ...
+    *   Tight loops use limited statements, so they neither flood the stream nor serialize the threads
     */
 
     auto func_thread_one = [](){
@@ -148,7 +160,7 @@ int main(int argc, char** argv){
         log(LOG_INFO) << "thread ONE is alive";
         int count {0};
         while(count <= 20){
-            log(LOG_WARN) << "thread ONE : " << 1111 << " val";
+            LOG_EVERY_N(LOG_WARN, 5) << "thread ONE : " << 1111 << " val";     ///> 1st, 6th, 11th ... (+ suppressed count)
             count++;
         }
         log(LOG_INFO) << "thread ONE kill";
@@ -158,7 +170,7 @@ int main(int argc, char** argv){
         log(LOG_INFO) << "thread TWO is alive";
         int count {0};
         while(count <= 20){
-            log(LOG_ERR) << "thread TWO : " << 2222 << " val";
+            LOG_RATE(LOG_ERR, 3) << "thread TWO : " << 2222 << " val";         ///> at most 3 lines per second
             count++;
         }
         log(LOG_INFO) << "thread ONE kill";
@@ -167,6 +179,13 @@ int main(int argc, char** argv){
     thread th_two  (func_thread_two);
     if (th_one.joinable()) { th_one.join(); }
     if (th_two.joinable()) { th_two.join(); }
+
+    ///> Plain statement in a hot loop: identical lines are folded into "last message repeated N times"
+    log.set_log_coalesce(milliseconds(100));
+    for (int count = 0; count <= 20; ++count){
+        log(LOG_WARN) << "thread MAIN : " << 3333 << " val";
+    }
+    log.set_log_coalesce(milliseconds(0));                                      ///> writes the pending summary
     
 #endif
 #if defined(PROGBAR)
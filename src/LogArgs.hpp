@@ -0,0 +1,99 @@
+#pragma once
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  INTERFACE ARGS                                                                                                  //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace args{
+/*
+*   Enable/Disable time/status/call_location part in log line
+*/
+enum l_action{
+    LOG_STYLE_OFF           = 0,
+    LOG_STYLE_ON            = 1
+};
+
+/*
+*   Log level to set and call
+*/
+enum l_level{
+    LOG_SILENT              = -1,       ///> SYSTEM DO NOT USE
+    LOG_ERR                 = 0,
+    LOG_WARN                = 1,
+    LOG_INFO                = 2,
+    LOG_TIME                = 3,
+    LOG_DONE                = 4,
+    LOG_DEBUG               = 5,        ///> DEBUG
+    LOG_DEFAULT             = 4         ///> without DEBUG
+};
+
+/*
+*   Log color style settings
+*/
+enum l_style{
+    LOG_COLORS_NONE         = 0,
+    LOG_COLORS_REGULAR      = 1,
+    LOG_COLORS_BOLD         = 2,
+    LOG_COLORS_BACKGROUND   = 3,
+    LOG_COLORS_UNDERLINE    = 4,
+    LOG_COLORS_INHERIT      = 5         ///> sink follows set_log_style_colors
+};
+
+/*
+*   Line format of a sink
+*/
+enum l_format{
+    LOG_FORMAT_TEXT         = 0,        ///> pattern / style modules, log_kv fields as ' key=value'
+    LOG_FORMAT_JSON         = 1,        ///> JSON Lines: time, level, thread, file, line, msg & log_kv fields
+    LOG_FORMAT_INHERIT      = 2         ///> sink follows set_log_format
+};
+
+/*
+*   Terminal detection of a sink: sinks that are no terminal get plain lines (no color escapes, user escapes stripped)
+*/
+enum l_tty{
+    LOG_TTY_AUTO            = 0,        ///> ostream sinks: isatty() of cout/cerr/clog, other sinks: no terminal
+    LOG_TTY_ON              = 1,        ///> colors as configured
+    LOG_TTY_OFF             = 2         ///> always plain
+};
+
+/*
+*   Clock source of the timing features
+*/
+enum l_clock{
+    LOG_CLOCK_STEADY        = 0,        ///> steady_clock
+    LOG_CLOCK_TSC           = 1         ///> calibrated invariant TSC (falls back to steady_clock)
+};
+
+/*
+*   Delivery mode of finished lines (async modes differ by full-queue policy)
+*/
+enum l_async{
+    LOG_ASYNC_OFF           = 0,        ///> write on the calling thread
+    LOG_ASYNC_BLOCK         = 1,        ///> sleep until the writer frees a slot
+    LOG_ASYNC_DROP_NEWEST   = 2,        ///> discard the line being logged
+    LOG_ASYNC_DROP_OLDEST   = 3         ///> discard the oldest queued line
+};
+
+/*
+*   Sub-second digits of the time module
+*/
+enum l_time_prec{
+    LOG_TIME_SEC            = 0,        ///> 13:17:26
+    LOG_TIME_MSEC           = 1,        ///> 13:17:26.123
+    LOG_TIME_USEC           = 2         ///> 13:17:26.123456
+};
+
+/*
+*   Layout & zone of the time module
+*/
+enum l_time_fmt{
+    LOG_TIME_LOCAL          = 0,        ///> [ D ..; T .. ] local time
+    LOG_TIME_UTC            = 1,        ///> [ D ..; T .. ] UTC
+    LOG_TIME_ISO8601        = 2,        ///> [ 2023-08-21T13:17:26+02:00 ]
+    LOG_TIME_ISO8601_UTC    = 3         ///> [ 2023-08-21T11:17:26Z ]
+};
+}
+
+}
@@ -0,0 +1,397 @@
+#include <LogBinary.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+#include <LogLayout.hpp>
+
+using namespace std;
+using namespace chrono;
+
+namespace cpp_up{
+
+struct LogBinary::registry{
+    mutex                               mtx;
+    vector<pair<const char*, unsigned>> sites;
+    vector<unique_ptr<LogLiteral>>      literals;
+    unordered_map<string, const LogLiteral*> literal_ids;                          ///> by text
+    map<pair<string, unsigned>, unique_ptr<LogSite>> explicit_sites;                ///> log(ll, file, line), by content
+    vector<LogBinary*>                  live;
+    uint64_t                            serial  {0};
+};
+
+LogBinary::registry& LogBinary::reg(){
+    static registry& r = *new registry;                                             ///> outlives static Loggers
+    return r;
+}
+
+LogBinary::LogBinary(const string& _path, size_t _c)
+    : _chunk(_c)
+{
+    registry& r = reg();
+    {
+        lock_guard<mutex> lock(r.mtx);
+        _serial = ++r.serial;
+        r.live.push_back(this);
+    }
+    _file = fopen(_path.c_str(), "wb");
+    if (_file){
+        fwrite("CPUPBIN1", 1, 8, _file);
+    }
+}
+
+LogBinary::~LogBinary(){
+    registry& r = reg();
+    {
+        lock_guard<mutex> lock(r.mtx);
+        r.live.erase(find(r.live.begin(), r.live.end(), this));
+    }
+    flush();
+    if (_file){
+        fclose(_file);
+    }
+}
+
+string& LogBinaryRecord::scratch(){
+    static thread_local string s;
+    return s;
+}
+
+const LogLiteral* LogBinaryRecord::register_literal(atomic<const LogLiteral*>& slot, string_view text){
+    return LogBinary::register_literal(slot, text);
+}
+
+void LogBinaryRecord::end(){
+    LogBinary::buffer& b = static_cast<LogBinary::buffer&>(*this);                  ///> every record is begun in a thread buffer
+    b.owner->end(b);
+}
+
+uint32_t LogBinary::register_site(LogSite& site){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    uint32_t id = site.bin_id.load(memory_order_relaxed);
+    if (id == 0){
+        r.sites.push_back({site.file, site.line});
+        id = static_cast<uint32_t>(r.sites.size());
+        site.bin_id.store(id, memory_order_release);
+    }
+    return id;
+}
+
+LogSite& LogBinary::site(const char* file, unsigned line){
+    struct cache{
+        const char*     file    {nullptr};
+        unsigned        line    {0};
+        LogSite*        site    {nullptr};
+    };
+    static thread_local cache tl;                                                   ///> repeated statement: no lock
+    if (tl.site && tl.file == file && tl.line == line){
+        return *tl.site;
+    }
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    auto it = r.explicit_sites.try_emplace({file, line}).first;
+    if (!it->second){
+        it->second.reset(new LogSite{it->first.first.c_str(), line});               ///> the key outlives the caller's string
+    }
+    tl = {file, line, it->second.get()};
+    return *it->second;
+}
+
+const LogLiteral* LogBinary::register_literal(atomic<const LogLiteral*>& slot, string_view text){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    string key(text);
+    auto it = r.literal_ids.find(key);
+    const LogLiteral* l;
+    if (it != r.literal_ids.end()){
+        l = it->second;
+    }
+    else{
+        if (r.literals.size() >= 0xFFFF){
+            return nullptr;                                                         ///> id space used up (changing arrays): store as string
+        }
+        r.literals.emplace_back(new LogLiteral{static_cast<uint32_t>(r.literals.size() + 1), key});
+        l = r.literals.back().get();
+        r.literal_ids.emplace(move(key), l);
+    }
+    slot.store(l, memory_order_release);
+    return l;
+}
+
+LogBinary::buffer& LogBinary::local(){
+    struct cache{
+        LogBinary*      owner   {nullptr};
+        uint64_t        serial  {0};
+        buffer*         buf     {nullptr};
+        ~cache(){
+            if (owner){
+                registry& r = reg();
+                lock_guard<mutex> lock(r.mtx);
+                if (find(r.live.begin(), r.live.end(), owner) != r.live.end() && owner->_serial == serial){
+                    owner->release(buf);
+                }
+            }
+        }
+    };
+    static thread_local cache tl;
+    if (tl.owner == this && tl.serial == _serial){
+        return *tl.buf;
+    }
+
+    if (tl.owner){
+        registry& r = reg();
+        lock_guard<mutex> lock(r.mtx);
+        if (find(r.live.begin(), r.live.end(), tl.owner) != r.live.end() && tl.owner->_serial == tl.serial){
+            tl.owner->release(tl.buf);
+        }
+    }
+    buffer* b = nullptr;
+    {
+        lock_guard<mutex> lock(_mutex);
+        for (unique_ptr<buffer>& p : _buffers){
+            if (p->free){
+                b = p.get();
+                b->free = false;
+                break;
+            }
+        }
+        if (!b){
+            _buffers.emplace_back(new buffer());
+            b = _buffers.back().get();
+            b->owner = this;
+            b->data.reserve(_chunk + (_chunk >> 2));
+        }
+    }
+    while (b->busy.exchange(true, memory_order_acquire)){
+        this_thread::yield();
+    }
+    write_chunk(*b);                                                                ///> left over by an exited thread
+    b->tid = log_thread_id();
+    b->busy.store(false, memory_order_release);
+
+    tl.owner  = this;
+    tl.serial = _serial;
+    tl.buf    = b;
+    return *b;
+}
+
+void LogBinary::release(buffer* b){
+    lock_guard<mutex> lock(_mutex);
+    b->free = true;
+}
+
+LogBinary::buffer& LogBinary::begin(LogSite& site, unsigned level, system_clock::time_point tp){
+    uint32_t id = site.bin_id.load(memory_order_acquire);
+    if (id == 0){
+        id = register_site(site);
+    }
+    buffer& b = local();
+    int64_t ns = duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+    if (b.open){
+        ///> logged from an operand of the open record (busy is ours): write it aside, it follows the open one
+        b.nest.push_back({string(), b.site, b.arg, b.nested.size()});
+        b.nest.back().data.swap(b.data);
+        b.depth = static_cast<unsigned>(b.nest.size());
+    }
+    else{
+        while (b.busy.exchange(true, memory_order_acquire)){
+            this_thread::yield();                                                   ///> flush() is writing it
+        }
+        b.open = true;
+        if (b.data.empty()){
+            b.base = ns;
+            b.last = ns;
+        }
+    }
+    LogBinaryRecord::put_varint(b.data, static_cast<uint64_t>(id) << 3 | (level & 7));
+    LogBinaryRecord::put_varint(b.data, LogBinaryRecord::zigzag(ns - b.last));
+    b.last = ns;
+    b.site = &site;
+    b.arg  = 0;
+    return b;
+}
+
+void LogBinary::close_nested(buffer& b){
+    frame& f = b.nest.back();
+    b.nested.insert(f.at, b.data);                                                  ///> records begun earlier stay first: time deltas chain
+    b.data.swap(f.data);
+    b.site = f.site;
+    b.arg  = f.arg;
+    b.nest.pop_back();
+    b.depth = static_cast<unsigned>(b.nest.size());
+}
+
+void LogBinary::write_descriptors(){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    for (; _sites_done < r.sites.size(); ++_sites_done){
+        const char* f = r.sites[_sites_done].first;
+        size_t n = f ? strlen(f) : 0;
+        _head.push_back('S');
+        LogBinaryRecord::put_varint(_head, _sites_done + 1);
+        LogBinaryRecord::put_varint(_head, r.sites[_sites_done].second);
+        LogBinaryRecord::put_varint(_head, n);
+        _head.append(f ? f : "", n);
+    }
+    for (; _literals_done < r.literals.size(); ++_literals_done){
+        _head.push_back('L');
+        LogBinaryRecord::put_varint(_head, _literals_done + 1);
+        LogBinaryRecord::put_varint(_head, r.literals[_literals_done]->text.size());
+        _head.append(r.literals[_literals_done]->text);
+    }
+}
+
+void LogBinary::write_chunk(buffer& b){
+    if (b.data.empty()){
+        return;
+    }
+    lock_guard<mutex> lock(_file_mutex);
+    if (_file){
+        _head.clear();
+        write_descriptors();                                                        ///> everything the chunk can refer to
+        _head.push_back('C');
+        LogBinaryRecord::put_varint(_head, b.tid);
+        _head.append(reinterpret_cast<const char*>(&b.base), sizeof(b.base));
+        LogBinaryRecord::put_varint(_head, b.data.size());
+        fwrite(_head.data(), 1, _head.size(), _file);
+        fwrite(b.data.data(), 1, b.data.size(), _file);
+    }
+    b.data.clear();
+}
+
+void LogBinary::flush(){
+    {
+        lock_guard<mutex> lock(_mutex);
+        for (unique_ptr<buffer>& p : _buffers){
+            while (p->busy.exchange(true, memory_order_acquire)){
+                this_thread::yield();
+            }
+            write_chunk(*p);
+            p->busy.store(false, memory_order_release);
+        }
+    }
+    lock_guard<mutex> lock(_file_mutex);
+    if (_file){
+        fflush(_file);
+    }
+}
+
+bool LogBinary::decode(const string& in, decoded& out){
+    const char* p   = in.data();
+    const char* end = p + in.size();
+    auto varint = [&](uint64_t& v){
+        v = 0;
+        for (unsigned shift = 0; p < end && shift < 64; shift += 7){
+            uint8_t c = static_cast<uint8_t>(*p++);
+            v |= static_cast<uint64_t>(c & 0x7F) << shift;
+            if (!(c & 0x80)){
+                return true;
+            }
+        }
+        return false;
+    };
+    auto bytes = [&](size_t n, string_view& s){
+        if (static_cast<size_t>(end - p) < n){
+            return false;
+        }
+        s = string_view(p, n);
+        p += n;
+        return true;
+    };
+
+    string_view s;
+    if (!bytes(8, s) || s != "CPUPBIN1"){
+        return false;
+    }
+    while (p < end){
+        char kind = *p++;
+        uint64_t id = 0, a = 0, n = 0;
+        if (kind == 'S' || kind == 'L'){
+            if (!varint(id) || (kind == 'S' && !varint(a)) || !varint(n) || !bytes(n, s) || id == 0){
+                return false;
+            }
+            if (kind == 'S'){
+                out.sites.resize(max<size_t>(out.sites.size(), id));
+                out.sites[id - 1] = {string(s), static_cast<unsigned>(a)};
+            }
+            else{
+                out.literals.resize(max<size_t>(out.literals.size(), id));
+                out.literals[id - 1] = string(s);
+            }
+            continue;
+        }
+        if (kind != 'C'){
+            return false;
+        }
+        uint64_t tid;
+        int64_t ns;
+        if (!varint(tid) || !bytes(sizeof(ns), s) || !varint(n) || static_cast<uint64_t>(end - p) < n){
+            return false;
+        }
+        memcpy(&ns, s.data(), sizeof(ns));
+        const char* chunk_end = p + n;
+        const char* outer_end = end;
+        end = chunk_end;
+        while (p < end){
+            uint64_t head, delta;
+            if (!varint(head) || !varint(delta)){
+                return false;
+            }
+            ns += static_cast<int64_t>(delta >> 1) ^ -static_cast<int64_t>(delta & 1);
+            decoded::entry e {ns, tid, static_cast<uint32_t>(head >> 3), static_cast<unsigned>(head & 7), {}};
+            for (;;){
+                if (p >= end){
+                    return false;
+                }
+                uint8_t t = static_cast<uint8_t>(*p++);
+                if (t == LogBinaryRecord::TAG_END){
+                    break;
+                }
+                switch (t){
+                case LogBinaryRecord::TAG_INT:
+                    if (!varint(a)) return false;
+                    log_append(e.body, static_cast<int64_t>(a >> 1) ^ -static_cast<int64_t>(a & 1));
+                    break;
+                case LogBinaryRecord::TAG_UINT:
+                    if (!varint(a)) return false;
+                    log_append(e.body, a);
+                    break;
+                case LogBinaryRecord::TAG_DOUBLE:{
+                    double x;
+                    if (!bytes(sizeof(x), s)) return false;
+                    memcpy(&x, s.data(), sizeof(x));
+                    log_append(e.body, x);
+                    break;
+                }
+                case LogBinaryRecord::TAG_FALSE:
+                case LogBinaryRecord::TAG_TRUE:
+                    log_append(e.body, t == LogBinaryRecord::TAG_TRUE);
+                    break;
+                case LogBinaryRecord::TAG_CHAR:
+                    if (!bytes(1, s)) return false;
+                    e.body.push_back(s[0]);
+                    break;
+                case LogBinaryRecord::TAG_STRING:
+                    if (!varint(a) || !bytes(a, s)) return false;
+                    e.body.append(s);
+                    break;
+                case LogBinaryRecord::TAG_LITERAL:
+                    if (!varint(a) || a == 0 || a > out.literals.size()) return false;
+                    e.body.append(out.literals[a - 1]);
+                    break;
+                default:
+                    return false;
+                }
+            }
+            out.entries.push_back(move(e));
+        }
+        end = outer_end;
+    }
+    return true;
+}
+
+}
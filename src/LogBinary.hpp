@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <LogSite.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogBinary                                                                                                       //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Binary deferred-format log stream
+*   - the call site is described once (file, line, literal text); a line only records the descriptor id,
+*     the level, a time delta and the raw argument values into a per-thread buffer
+*   - full buffers are written as one chunk; formatting happens offline (cpp_up_logdecode)
+*   - LOG_MSG & LOG_CAT own their site; log(ll, file, line) shares one site per (file, line) pair,
+*     plain log(ll) has no call site: its records decode without file & line
+*
+*   stream  : "CPUPBIN1" { 'S' site | 'L' literal | 'C' chunk }
+*   'S'     : varint id, varint line, varint length, file name
+*   'L'     : varint id, varint length, text
+*   'C'     : varint thread id, int64 base time (ns), varint length, records
+*   record  : varint id << 3 | level, zigzag varint time delta (ns), arguments, TAG_END
+*   integers are little-endian, varints are LEB128
+*/
+class LogBinary{
+public:
+    using tag = LogBinaryRecord::tag;                                               ///> argument tags (LogSite.hpp)
+
+    /*
+    *   Record left open by a statement that logs from one of its << operands
+    */
+    struct frame{
+        std::string     data;
+        LogSite*        site;
+        unsigned        arg;
+        size_t          at;                                                         ///> its place in buffer::nested
+    };
+
+    /*
+    *   Per-thread record buffer (owned by the stream, reused once its thread has exited)
+    */
+    struct alignas(64) buffer : LogBinaryRecord{
+        LogBinary*      owner                   {nullptr};
+        std::atomic<bool> busy                  {false};                            ///> owner appends / flush() writes
+        bool            free                    {false};
+        bool            open                    {false};                            ///> a record is being written (owner thread only)
+        std::vector<frame> nest                 {};                                 ///> outer records of nested statements
+        std::string     nested                  {};                                 ///> finished nested records, in begin order
+        uint64_t        tid                     {0};
+        int64_t         base                    {0};                                ///> time of the first record
+        int64_t         last                    {0};                                ///> time of the previous record
+    };
+
+    /*
+    *   Result of decode()
+    */
+    struct decoded{
+        struct entry{
+            int64_t     ns;
+            uint64_t    tid;
+            uint32_t    site;
+            unsigned    level;
+            std::string body;
+        };
+        std::vector<std::pair<std::string, unsigned>> sites;                        ///> id -> file, line
+        std::vector<std::string>        literals;                                   ///> id -> text
+        std::vector<entry>              entries;                                    ///> in stream order
+    };
+
+    /*
+    *   Construct
+    */
+    explicit            LogBinary               (const std::string&, size_t chunk = 64 << 10);
+    inline              LogBinary               (LogBinary& _src)       = delete;   ///> Copy semantics
+    inline              LogBinary& operator=    (LogBinary const&)      = delete;
+                        ~LogBinary              ();                                 ///> Write every buffer & close
+
+    /*
+    *   SYSTEM CONTROL
+    */
+    buffer&             begin                   (LogSite&, unsigned, std::chrono::system_clock::time_point); ///> Open record in the thread buffer (arguments: LogBinaryRecord)
+    inline void         end                     (buffer&);                          ///> Close record
+    void                flush                   ();                                 ///> Write every thread buffer & flush the file
+    inline bool         is_open                 () const { return _file != nullptr; }
+
+    static bool         decode                  (const std::string&, decoded&);    ///> false on a damaged stream (entries so far are kept)
+    static LogSite&     site                    (const char*, unsigned);            ///> Site of an explicit file & line (created once, never freed)
+
+private:
+    friend struct LogBinaryRecord;
+    struct registry;
+
+    static registry&    reg                     ();                                 ///> Process-wide descriptors (never destroyed)
+    static uint32_t     register_site           (LogSite&);
+    static const LogLiteral* register_literal   (std::atomic<const LogLiteral*>&, std::string_view);
+    static void         close_nested            (buffer&);                          ///> end() of a record opened inside another one
+
+    buffer&             local                   ();                                 ///> Buffer of the calling thread
+    void                release                 (buffer*);
+    void                write_chunk             (buffer&);                          ///> Caller holds buffer::busy
+    void                write_descriptors       ();                                 ///> Caller holds _file_mutex
+
+    FILE*               _file                   {nullptr};
+    size_t              _chunk;
+    uint64_t            _serial;
+    std::mutex          _mutex;                                                     ///> buffer list
+    std::vector<std::unique_ptr<buffer>> _buffers;
+    std::mutex          _file_mutex;
+    size_t              _sites_done             {0};
+    size_t              _literals_done          {0};
+    std::string         _head;
+};
+
+
+
+void LogBinary::end(buffer& b){
+    b.data.push_back(static_cast<char>(LogBinaryRecord::TAG_END));
+    if (!b.nest.empty()){
+        close_nested(b);
+        return;
+    }
+    if (!b.nested.empty()){
+        b.data.append(b.nested);                                                    ///> after the record they were logged in
+        b.nested.clear();
+    }
+    b.open = false;
+    if (b.data.size() >= _chunk){
+        write_chunk(b);
+    }
+    b.busy.store(false, std::memory_order_release);
+}
+
+}
@@ -0,0 +1,168 @@
+#include <LogCategory.hpp>
+
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace cpp_up{
+
+struct LogCategory::registry{
+    mutex                           mtx;
+    array<atomic<unsigned>, MAX>    levels  {};
+    array<bool, MAX>                own     {};                                     ///> level set explicitly
+    vector<string>                  names   {""};                                   ///> per used slot
+    unordered_map<string, size_t>   slots;
+    unordered_map<string, unsigned> wanted;                                         ///> explicit levels by name
+};
+
+LogCategory::registry& LogCategory::reg(){
+    static registry& r = []() -> registry& {
+        registry* p = new registry;
+        p->levels[0].store(4, memory_order_relaxed);                                ///> args::LOG_DEFAULT
+        if (const char* env = getenv("CPP_UP_LOG")){
+            apply(*p, env);
+        }
+        return *p;
+    }();
+    return r;
+}
+
+bool LogCategory::parse_level(const string& s, unsigned& ll){
+    static const char* names[][2] {{"err", "error"}, {"warn", "warning"}, {"info", "info"},
+                                   {"time", "time"}, {"done", "done"}, {"debug", "debug"}};
+    string v;
+    for (char c : s){
+        if (!isspace(static_cast<unsigned char>(c))){
+            v += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    for (unsigned i = 0; i < 6; ++i){
+        if (v == names[i][0] || v == names[i][1] || v == to_string(i)){
+            ll = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogCategory::apply(registry& r, const string& spec){
+    bool ok = true;
+    size_t from = 0;
+    while (from <= spec.size()){
+        size_t to = spec.find(',', from);
+        if (to == string::npos){
+            to = spec.size();
+        }
+        string item = spec.substr(from, to - from);
+        from = to + 1;
+        if (item.find_first_not_of(" \t") == string::npos){
+            continue;
+        }
+        size_t eq = item.find('=');
+        unsigned ll = 0;
+        if (!parse_level(eq == string::npos ? item : item.substr(eq + 1), ll)){
+            ok = false;
+            continue;
+        }
+        if (eq == string::npos){
+            set_default(r, ll);
+            continue;
+        }
+        string name = item.substr(0, eq);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        set_level(r, name, ll);
+    }
+    return ok;
+}
+
+void LogCategory::set_default(registry& r, unsigned ll){
+    r.levels[0].store(ll, memory_order_relaxed);
+    for (size_t i = 1; i < r.names.size(); ++i){
+        if (!r.own[i]){
+            r.levels[i].store(ll, memory_order_relaxed);
+        }
+    }
+}
+
+void LogCategory::set_level(registry& r, const string& name, unsigned ll){
+    r.wanted[name] = ll;
+    auto it = r.slots.find(name);
+    if (it != r.slots.end() && it->second != 0){
+        r.own[it->second] = true;
+        r.levels[it->second].store(ll, memory_order_relaxed);
+    }
+}
+
+LogCategory::LogCategory(const char* n)
+    : _name(n)
+{
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    auto it = r.slots.find(n);
+    size_t slot = 0;
+    if (it != r.slots.end()){
+        slot = it->second;
+    }
+    else if (r.names.size() < MAX){
+        slot = r.names.size();
+        r.names.emplace_back(n);
+        r.slots.emplace(n, slot);
+        auto w = r.wanted.find(n);
+        r.own[slot] = w != r.wanted.end();
+        r.levels[slot].store(r.own[slot] ? w->second : r.levels[0].load(memory_order_relaxed), memory_order_relaxed);
+    }
+    _level = &r.levels[slot];
+}
+
+void LogCategory::set_level(const string& name, unsigned ll){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    set_level(r, name, ll);
+}
+
+void LogCategory::reset_level(const string& name){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    r.wanted.erase(name);
+    auto it = r.slots.find(name);
+    if (it != r.slots.end() && it->second != 0){
+        r.own[it->second] = false;
+        r.levels[it->second].store(r.levels[0].load(memory_order_relaxed), memory_order_relaxed);
+    }
+}
+
+void LogCategory::set_default(unsigned ll){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    set_default(r, ll);
+}
+
+bool LogCategory::configure(const string& spec){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    return apply(r, spec);
+}
+
+atomic<unsigned>* LogCategory::levels(){
+    return reg().levels.data();
+}
+
+string LogCategory::list(){
+    static const char* names[] {"err", "warn", "info", "time", "done", "debug"};
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    string spec;
+    for (size_t i = 1; i < r.names.size(); ++i){
+        unsigned ll = r.levels[i].load(memory_order_relaxed);
+        spec.append(spec.empty() ? "" : ",").append(r.names[i]).append("=").append(ll < 6 ? names[ll] : to_string(ll));
+    }
+    return spec;
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogCategory                                                                                                     //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Named log category (module) with its own runtime level
+*   - registered at static init (LOG_CATEGORY), one slot per name in a process-wide atomic table
+*   - enabled() is a single relaxed load; slot 0 is the default level (Logger::set_log_level)
+*   - a category without an own level follows the default; names may be registered in several translation units
+*   - CPP_UP_LOG="net=debug,db=warn,info" sets levels at startup (a bare level is the default);
+*     levels: err|error, warn|warning, info, time, done, debug or 0..5
+*   - more than MAX - 1 names share the default slot
+*/
+class LogCategory{
+public:
+    static constexpr size_t MAX = 256;
+
+    explicit            LogCategory             (const char*);
+    inline              LogCategory             (const LogCategory&)        = delete;
+    inline              LogCategory& operator=  (const LogCategory&)        = delete;
+
+    inline bool         enabled                 (unsigned ll) const { return ll <= _level->load(std::memory_order_relaxed); }
+    inline unsigned     level                   () const { return _level->load(std::memory_order_relaxed); }
+    inline const char*  name                    () const { return _name; }
+    inline void         set_level               (unsigned ll) { set_level(_name, ll); }
+
+    static void         set_level               (const std::string&, unsigned);     ///> By name, also for categories registered later
+    static void         reset_level             (const std::string&);               ///> Follow the default level again
+    static void         set_default             (unsigned);                         ///> Slot 0 & every category without an own level
+    static bool         configure               (const std::string&);               ///> "net=debug,db=warn,info", false on a bad entry (rest applied)
+    static inline std::atomic<unsigned>& default_level () { static std::atomic<unsigned>& l = *levels(); return l; }
+    static std::string  list                    ();                                 ///> Registered names & current levels, as configure() takes them
+    static bool         parse_level             (const std::string&, unsigned&);
+
+private:
+    struct registry;
+    static registry&    reg                     ();                                 ///> Created on first use (static init safe), never destroyed
+    static std::atomic<unsigned>* levels        ();                                 ///> reg().levels, slot 0 = default
+    static bool         apply                   (registry&, const std::string&);    ///> Caller holds mtx (or owns r)
+    static void         set_default             (registry&, unsigned);
+    static void         set_level               (registry&, const std::string&, unsigned);
+
+    const char*         _name;
+    std::atomic<unsigned>* _level;
+};
+
+/*
+*   Define a category at namespace/function scope: LOG_CATEGORY(net_log, "net");
+*/
+#define LOG_CATEGORY(V, N)  static cpp_up::LogCategory V {(N)}
+
+}
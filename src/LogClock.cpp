@@ -0,0 +1,89 @@
+#include <LogClock.hpp>
+
+#include <algorithm>
+#include <mutex>
+
+#if CPP_UP_LOG_TSC
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+using namespace chrono;
+
+namespace cpp_up{
+
+bool LogClock::tsc_invariant(){
+#if CPP_UP_LOG_TSC
+    unsigned a = 0, b = 0, c = 0, d = 0;
+    if (__get_cpuid(0x80000000u, &a, &b, &c, &d) == 0 || a < 0x80000007u){
+        return false;
+    }
+    __get_cpuid(0x80000007u, &a, &b, &c, &d);
+    return (d & (1u << 8)) != 0;                                                    ///> "invariant TSC" bit
+#else
+    return false;
+#endif
+}
+
+void LogClock::calibrate(){
+#if CPP_UP_LOG_TSC
+    if (!tsc_invariant()){
+        return;
+    }
+    ///> pair a steady_clock reading with the TSC: keep the tightest of a few bracketing attempts
+    auto sample = [](uint64_t& tsc, uint64_t& ns){
+        uint64_t best = UINT64_MAX;
+        for (int i = 0; i < 16; ++i){
+            uint64_t t0 = __rdtsc();
+            uint64_t n  = steady_ns();
+            uint64_t t1 = __rdtsc();
+            if (t1 - t0 < best){
+                best = t1 - t0;
+                tsc  = t0 + (t1 - t0) / 2;
+                ns   = n;
+            }
+        }
+    };
+    uint64_t tsc0 = 0, ns0 = 0, tsc1 = 0, ns1 = 0;
+    sample(tsc0, ns0);
+    while (steady_ns() - ns0 < 10000000){}                                          ///> 10 ms window
+    sample(tsc1, ns1);
+    if (tsc1 <= tsc0 || ns1 <= ns0){
+        return;
+    }
+    _mult     = static_cast<uint64_t>((static_cast<unsigned __int128>(ns1 - ns0) << 32) / (tsc1 - tsc0));
+    _base_tsc = tsc1;
+    _base_ns  = ns1;
+    _tsc_ok   = _mult != 0;
+#endif
+}
+
+bool LogClock::set_source(unsigned s){
+    if (s == TSC){
+        static once_flag once;
+        call_once(once, calibrate);
+        if (!_tsc_ok){
+            _src.store(STEADY, memory_order_release);
+            return false;
+        }
+    }
+    else{
+        s = STEADY;
+    }
+    _src.store(s, memory_order_release);
+    overhead();
+    return true;
+}
+
+uint64_t LogClock::measure(){
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; ++i){
+        uint64_t a = now();
+        uint64_t b = now();
+        best = min(best, b - a);
+    }
+    return best;
+}
+
+}
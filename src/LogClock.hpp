@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CPP_UP_LOG_TSC      1
+#else
+#define CPP_UP_LOG_TSC      0
+#endif
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogClock                                                                                                        //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Clock of the timing features (snapshots, ScopedTimer, LogTrace, LOG_RATE): ns on the steady_clock timeline
+*   - STEADY: steady_clock::now() (a vDSO call, ~20 ns)
+*   - TSC   : rdtsc scaled to ns (a few ns); only with an invariant TSC (constant rate, runs in every C-state),
+*             calibrated against steady_clock once (~10 ms) when first selected; it does not follow NTP slewing
+*             of steady_clock afterwards (tens of ppm)
+*   - overhead(): measured cost of one now() of the active source, elapsed() subtracts it from a delta
+*/
+class LogClock{
+public:
+    enum source : unsigned{
+        STEADY              = 0,
+        TSC                 = 1
+    };
+
+    static inline uint64_t  now                 ();                                 ///> ns, active source
+    static inline uint64_t  elapsed             (uint64_t, uint64_t);               ///> to - from - overhead(), >= 0
+    static bool             set_source          (unsigned);                         ///> false = no invariant TSC, STEADY kept
+    static inline unsigned  get_source          () { return _src.load(std::memory_order_relaxed); }
+    static bool             tsc_invariant       ();
+    static inline uint64_t  overhead            ();                                 ///> ns spent inside one now()
+
+private:
+    static inline uint64_t  steady_ns           () {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    static void             calibrate           ();
+    static uint64_t         measure             ();                                 ///> min cost of now() over back-to-back pairs
+
+    inline static std::atomic<unsigned> _src    {STEADY};
+    inline static std::atomic<uint64_t> _overhead[2] {{UINT64_MAX}, {UINT64_MAX}}; ///> per source, measured on first use
+    inline static uint64_t  _base_tsc           {0};
+    inline static uint64_t  _base_ns            {0};
+    inline static uint64_t  _mult               {0};                                ///> ns per tick, 32.32 fixed point
+    inline static bool      _tsc_ok             {false};
+};
+
+
+
+uint64_t LogClock::now(){
+#if CPP_UP_LOG_TSC
+    if (_src.load(std::memory_order_acquire) == TSC){
+        uint64_t t = __builtin_ia32_rdtsc();
+        return t > _base_tsc ? _base_ns + static_cast<uint64_t>((static_cast<unsigned __int128>(t - _base_tsc) * _mult) >> 32)
+                             : _base_ns;
+    }
+#endif
+    return steady_ns();
+}
+
+uint64_t LogClock::elapsed(uint64_t from, uint64_t to){
+    uint64_t d   = to > from ? to - from : 0;
+    uint64_t ovh = overhead();
+    return d > ovh ? d - ovh : 0;
+}
+
+uint64_t LogClock::overhead(){
+    unsigned s  = _src.load(std::memory_order_relaxed);
+    uint64_t o  = _overhead[s].load(std::memory_order_relaxed);
+    if (o == UINT64_MAX){
+        o = measure();                                                              ///> racing threads measure alike
+        _overhead[s].store(o, std::memory_order_relaxed);
+    }
+    return o;
+}
+
+}
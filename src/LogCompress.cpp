@@ -0,0 +1,310 @@
+#include <LogCompress.hpp>
+
+#include <memory>
+
+using namespace std;
+using namespace chrono;
+
+namespace cpp_up{
+
+uint8_t* LogCodec::put_length(uint8_t* op, size_t n){
+    while (n >= 255){
+        *op++ = 255;
+        n -= 255;
+    }
+    *op++ = static_cast<uint8_t>(n);
+    return op;
+}
+
+void LogCodec::wild_copy(uint8_t* d, const uint8_t* s, size_t n){
+    uint8_t* const e = d + n;
+    do{
+        memcpy(d, s, 8);
+        d += 8;
+        s += 8;
+    } while (d < e);
+}
+
+size_t LogCodec::compress(const char* src, size_t n, char* dst){
+    const uint8_t* const base = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* const end  = base + n;
+    const uint8_t* ip         = base;
+    const uint8_t* anchor     = base;
+    uint8_t* op               = reinterpret_cast<uint8_t*>(dst);
+
+    if (n > MF_LIMIT){
+        const uint8_t* const mflimit    = end - MF_LIMIT;
+        const uint8_t* const matchlimit = end - LAST_LITERALS;
+        uint32_t table[1u << HASH_BITS];
+        memset(table, 0, sizeof(table));
+        ++ip;
+        while (ip < mflimit){
+            uint32_t h   = hash(ip);
+            const uint8_t* ref = base + table[h];
+            table[h] = static_cast<uint32_t>(ip - base);
+            if (ip - ref > 65535 || read32(ref) != read32(ip)){
+                ip += 1 + ((ip - anchor) >> 6);                                     ///> skip faster through incompressible data
+                continue;
+            }
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]){
+                --ip;
+                --ref;
+            }
+            ///> extend the match 8 bytes at a time
+            const uint8_t* p = ip + MIN_MATCH;
+            const uint8_t* q = ref + MIN_MATCH;
+            while (p + 8 <= matchlimit){
+                uint64_t diff = read64(p) ^ read64(q);
+                if (diff){
+                    p += static_cast<size_t>(__builtin_ctzll(diff)) >> 3;
+                    goto matched;
+                }
+                p += 8;
+                q += 8;
+            }
+            while (p < matchlimit && *p == *q){
+                ++p;
+                ++q;
+            }
+        matched:
+            size_t lit = static_cast<size_t>(ip - anchor);
+            size_t ml  = static_cast<size_t>(p - ip) - MIN_MATCH;
+            uint8_t* token = op++;
+            *token = static_cast<uint8_t>((lit < 15 ? lit : 15) << 4 | (ml < 15 ? ml : 15));
+            if (lit >= 15){
+                op = put_length(op, lit - 15);
+            }
+            wild_copy(op, anchor, lit);                                             ///> overrun is rewritten, bound() has room
+            op += lit;
+            uint16_t off = static_cast<uint16_t>(ip - ref);
+            *op++ = static_cast<uint8_t>(off);
+            *op++ = static_cast<uint8_t>(off >> 8);
+            if (ml >= 15){
+                op = put_length(op, ml - 15);
+            }
+            ip = anchor = p;
+            if (ip < mflimit){
+                table[hash(ip - 2)] = static_cast<uint32_t>(ip - 2 - base);
+            }
+        }
+    }
+    size_t lit = static_cast<size_t>(end - anchor);
+    *op++ = static_cast<uint8_t>((lit < 15 ? lit : 15) << 4);
+    if (lit >= 15){
+        op = put_length(op, lit - 15);
+    }
+    memcpy(op, anchor, lit);
+    op += lit;
+    return static_cast<size_t>(op - reinterpret_cast<uint8_t*>(dst));
+}
+
+bool LogCodec::decompress(const char* src, size_t n, char* dst, size_t raw){
+    const uint8_t* ip         = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* const iend = ip + n;
+    uint8_t* op               = reinterpret_cast<uint8_t*>(dst);
+    uint8_t* const obase      = op;
+    uint8_t* const oend       = op + raw;
+
+    auto length = [&](size_t& len) -> bool {
+        uint8_t b;
+        do{
+            if (ip >= iend){
+                return false;
+            }
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    };
+    while (ip < iend){
+        uint8_t token = *ip++;
+        size_t lit = token >> 4;
+        if (lit == 15 && !length(lit)){
+            return false;
+        }
+        if (lit > static_cast<size_t>(iend - ip) || lit > static_cast<size_t>(oend - op)){
+            return false;
+        }
+        if (static_cast<size_t>(iend - ip) >= lit + 8 && static_cast<size_t>(oend - op) >= lit + 8){
+            wild_copy(op, ip, lit);
+        }
+        else{
+            memcpy(op, ip, lit);
+        }
+        ip += lit;
+        op += lit;
+        if (ip == iend){
+            break;                                                                  ///> last literals
+        }
+        if (iend - ip < 2){
+            return false;
+        }
+        size_t off = ip[0] | static_cast<size_t>(ip[1]) << 8;
+        ip += 2;
+        size_t ml = token & 15;
+        if (ml == 15 && !length(ml)){
+            return false;
+        }
+        ml += MIN_MATCH;
+        if (off == 0 || off > static_cast<size_t>(op - obase) || ml > static_cast<size_t>(oend - op)){
+            return false;
+        }
+        const uint8_t* ref = op - off;
+        if (off >= 8 && static_cast<size_t>(oend - op) >= ml + 8){
+            wild_copy(op, ref, ml);                                                 ///> each step reads bytes already written
+            op += ml;
+        }
+        else if (off >= ml){
+            memcpy(op, ref, ml);
+            op += ml;
+        }
+        else{
+            for (size_t i = 0; i < ml; ++i){                                        ///> overlapping: repeats the pattern
+                *op++ = *ref++;
+            }
+        }
+    }
+    return op == oend;
+}
+
+bool LogCodec::compress_file(FILE* in, FILE* out){
+    unique_ptr<char[]> raw(new char[BLOCK]);
+    unique_ptr<char[]> packed(new char[bound(BLOCK) + 8]);
+    if (fwrite(MAGIC, 1, 4, out) != 4){
+        return false;
+    }
+    for (;;){
+        size_t n = fread(raw.get(), 1, BLOCK, in);
+        if (n == 0){
+            break;
+        }
+        uint8_t* hdr = reinterpret_cast<uint8_t*>(packed.get());
+        size_t c = compress(raw.get(), n, packed.get() + 8);
+        const char* payload = packed.get() + 8;
+        uint32_t stored = static_cast<uint32_t>(c);
+        if (c >= n){
+            payload = raw.get();                                                    ///> incompressible: store as is
+            stored  = static_cast<uint32_t>(n) | 0x80000000u;
+            c       = n;
+        }
+        put_u32(hdr, static_cast<uint32_t>(n));
+        put_u32(hdr + 4, stored);
+        if (fwrite(hdr, 1, 8, out) != 8 || fwrite(payload, 1, c, out) != c){
+            return false;
+        }
+    }
+    uint8_t tail[8] {};
+    return fwrite(tail, 1, 8, out) == 8 && !ferror(in);
+}
+
+bool LogCodec::decompress_file(FILE* in, FILE* out){
+    char magic[4];
+    if (fread(magic, 1, 4, in) != 4 || memcmp(magic, MAGIC, 4) != 0){
+        return false;
+    }
+    unique_ptr<char[]> raw(new char[BLOCK]);
+    unique_ptr<char[]> packed(new char[bound(BLOCK)]);
+    for (;;){
+        uint8_t hdr[8];
+        if (fread(hdr, 1, 8, in) != 8){
+            return false;                                                           ///> no end marker
+        }
+        uint32_t n      = get_u32(hdr);
+        uint32_t stored = get_u32(hdr + 4);
+        if (n == 0){
+            return true;
+        }
+        bool plain = stored & 0x80000000u;
+        size_t c   = stored & 0x7FFFFFFFu;
+        if (n > BLOCK || c > bound(BLOCK) || (plain && c != n)){
+            return false;
+        }
+        if (fread(plain ? raw.get() : packed.get(), 1, c, in) != c){
+            return false;
+        }
+        if (!plain && !decompress(packed.get(), c, raw.get(), n)){
+            return false;
+        }
+        if (fwrite(raw.get(), 1, n, out) != n){
+            return false;
+        }
+    }
+}
+
+CompressedFileSink::CompressedFileSink(const string& _p, const config& _c)
+    : FileSink(_p, _c, false)
+{
+    _compressor = thread(&CompressedFileSink::compress_loop, this);
+    start();                                                                        ///> archive()/rotated() need the members above
+}
+
+CompressedFileSink::~CompressedFileSink(){
+    stop_io();                                                                      ///> no archive()/rotated() after this point
+    {
+        lock_guard<mutex> lock(_c_mutex);
+        _c_stop = true;
+    }
+    _c_cv.notify_one();
+    _compressor.join();
+}
+
+string CompressedFileSink::archive(unsigned keep){
+    if (keep == 0){
+        remove(path().c_str());
+        return "";
+    }
+    string part = path() + ".part-" + to_string(duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count());
+    if (rename(path().c_str(), part.c_str()) != 0){
+        return "";
+    }
+    _keep = keep;
+    return part;
+}
+
+void CompressedFileSink::rotated(const string& part){
+    {
+        lock_guard<mutex> lock(_c_mutex);
+        _parts.emplace_back(part, _keep);
+    }
+    _c_cv.notify_one();
+}
+
+void CompressedFileSink::compress_loop(){
+    unique_lock<mutex> lock(_c_mutex);
+    for (;;){
+        _c_cv.wait(lock, [this]{ return _c_stop || !_parts.empty(); });
+        if (_parts.empty()){
+            break;                                                                  ///> stopping & drained
+        }
+        pair<string, unsigned> job = _parts.front();
+        _parts.pop_front();
+        lock.unlock();
+        compress_part(job.first, job.second);
+        lock.lock();
+    }
+}
+
+void CompressedFileSink::compress_part(const string& part, unsigned keep){
+    const string tmp = path() + ".cpz.tmp";
+    FILE* in  = fopen(part.c_str(), "rb");
+    FILE* out = in ? fopen(tmp.c_str(), "wb") : nullptr;
+    bool ok = in && out && LogCodec::compress_file(in, out);
+    if (in){
+        fclose(in);
+    }
+    if (out && fclose(out) != 0){
+        ok = false;
+    }
+    if (!ok){
+        remove(tmp.c_str());                                                        ///> keep the raw part
+        return;
+    }
+    remove((path() + "." + to_string(keep) + ".cpz").c_str());
+    for (unsigned i = keep - 1; i >= 1; --i){
+        rename((path() + "." + to_string(i) + ".cpz").c_str(), (path() + "." + to_string(i + 1) + ".cpz").c_str());
+    }
+    rename(tmp.c_str(), (path() + ".1.cpz").c_str());
+    remove(part.c_str());
+}
+
+}
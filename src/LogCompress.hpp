@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <LogFile.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogCodec                                                                                                        //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Dependency-free LZ77 block codec (LZ4-style sequences) and its streamable frame
+*   - block: sequences of [token][literal length+][literals][offset u16][match length+], 64 KB window,
+*     matches >= 4 bytes, the last 5 bytes are literals
+*   - frame: "CPZ1", then per block: raw size u32 LE, stored size u32 LE (bit 31 = stored uncompressed), payload;
+*     a raw size of 0 ends the frame (a missing end marker means a truncated file)
+*/
+class LogCodec{
+public:
+    static constexpr size_t     BLOCK           = 1 << 20;                          ///> raw bytes per frame block
+    static constexpr char       MAGIC[4]        {'C', 'P', 'Z', '1'};
+
+    static inline size_t        bound           (size_t n) { return n + n / 255 + 16; }
+    static size_t               compress        (const char*, size_t, char*);      ///> dst holds bound(n), returns size
+    static bool                 decompress      (const char*, size_t, char*, size_t);   ///> exact raw size, false on damaged input
+
+    static bool                 compress_file   (FILE*, FILE*);                     ///> Whole stream into one frame
+    static bool                 decompress_file (FILE*, FILE*);                     ///> One frame, false on damaged/truncated input
+
+private:
+    static inline uint32_t      read32          (const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+    static inline uint64_t      read64          (const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+    static inline uint32_t      hash            (const uint8_t* p) { return static_cast<uint32_t>(((read64(p) << 24) * 889523592379ull) >> (64 - HASH_BITS)); }   ///> of 5 bytes
+    static void                 wild_copy       (uint8_t*, const uint8_t*, size_t);  ///> 8-byte steps, may run up to 7 bytes past n
+    static uint8_t*             put_length      (uint8_t*, size_t);                 ///> 255-run length extension
+    static inline void          put_u32         (uint8_t* p, uint32_t v) { for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i)); }
+    static inline uint32_t      get_u32         (const uint8_t* p) { return p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24; }
+
+    static constexpr unsigned   HASH_BITS       = 12;                               ///> 16 KB table stays in L1
+    static constexpr size_t     MIN_MATCH       = 4;
+    static constexpr size_t     LAST_LITERALS   = 5;
+    static constexpr size_t     MF_LIMIT        = 12;                               ///> no match starts in the last 12 bytes
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  CompressedFileSink                                                                                              //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   FileSink whose rotated files are compressed by an own background thread
+*   - rotation hands the closed file over under a unique name ('log.txt.part-<ns>'), so the I/O thread never waits
+*   - the compressor writes 'log.txt.1.cpz', shifting older '.N.cpz' files (keeps max_files), then removes the part
+*   - parts left by a crash stay uncompressed next to the log
+*/
+class CompressedFileSink : public FileSink{
+public:
+                        CompressedFileSink      (const std::string&, const config&);
+                        ~CompressedFileSink     () override;                        ///> Stop I/O, compress pending parts, join
+
+protected:
+    std::string         archive                 (unsigned) override;
+    void                rotated                 (const std::string&) override;      ///> Queue part for compression
+
+private:
+    void                compress_loop           ();
+    void                compress_part           (const std::string&, unsigned);
+
+    std::mutex          _c_mutex;
+    std::condition_variable _c_cv;
+    std::deque<std::pair<std::string, unsigned>> _parts;                            ///> path, files to keep
+    unsigned            _keep                   {0};                                ///> I/O thread only
+    bool                _c_stop                 {false};
+    std::thread         _compressor;
+};
+
+}
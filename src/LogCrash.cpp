@@ -0,0 +1,166 @@
+#include <LogCrash.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+
+#include <sys/syscall.h>
+#include <time.h>
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+
+using namespace std;
+
+namespace cpp_up{
+
+struct sigaction    LogCrash::_prev[size(SIGNALS)];
+bool                LogCrash::_set[size(SIGNALS)];
+char                LogCrash::_stack[STACK];
+
+void LogEmergency::write_all(const char* p, size_t n){
+    int fd = _fd.load(memory_order_relaxed);
+    while (n > 0){
+        ssize_t w = ::write(fd, p, n);
+        if (w < 0){
+            if (errno == EINTR){
+                continue;
+            }
+            return;
+        }
+        p += w;
+        n -= static_cast<size_t>(w);
+    }
+}
+
+LogEmergency& LogEmergency::append(const char* p, size_t n){
+    n = n < CAPACITY - 1 - _n ? n : CAPACITY - 1 - _n;                              ///> keep a byte for '\n'
+    memcpy(_buf + _n, p, n);
+    _n += n;
+    return *this;
+}
+
+LogEmergency& LogEmergency::operator<<(const char* s){
+    return s ? append(s, strlen(s)) : append("(null)", 6);
+}
+
+LogEmergency& LogEmergency::operator<<(char c){
+    return append(&c, 1);
+}
+
+LogEmergency& LogEmergency::operator<<(const void* p){
+    static const char hex[] = "0123456789abcdef";
+    char tmp[18];
+    size_t i = sizeof(tmp);
+    uintptr_t u = reinterpret_cast<uintptr_t>(p);
+    do{
+        tmp[--i] = hex[u & 0xF];
+        u >>= 4;
+    } while (u != 0);
+    tmp[--i] = 'x';
+    tmp[--i] = '0';
+    return append(tmp + i, sizeof(tmp) - i);
+}
+
+LogEmergency& LogEmergency::operator<<(double v){
+    if (v != v){
+        return append("nan", 3);
+    }
+    if (v < 0){
+        *this << '-';
+        v = -v;
+    }
+    if (v >= 1e18){
+        return append("inf", 3);                                                    ///> out of integer range
+    }
+    uint64_t milli = static_cast<uint64_t>(v * 1000.0 + 0.5);
+    *this << milli / 1000 << '.';
+    char frac[3] = {static_cast<char>('0' + milli / 100 % 10), static_cast<char>('0' + milli / 10 % 10), static_cast<char>('0' + milli % 10)};
+    return append(frac, 3);
+}
+
+const char* LogCrash::name(int s){
+    switch (s){
+        case SIGSEGV:   return "SIGSEGV";
+        case SIGBUS:    return "SIGBUS";
+        case SIGILL:    return "SIGILL";
+        case SIGFPE:    return "SIGFPE";
+        case SIGABRT:   return "SIGABRT";
+        case SIGTERM:   return "SIGTERM";
+        case SIGINT:    return "SIGINT";
+        default:        return "signal";
+    }
+}
+
+bool LogCrash::install(hook h, void* ctx, bool terminate){
+    uninstall();
+#if defined(__GLIBC__)
+    void* warm[1];
+    backtrace(warm, 1);                                                             ///> loads libgcc now, not in the handler
+#endif
+    stack_t ss {};
+    ss.ss_sp    = _stack;
+    ss.ss_size  = STACK;
+    sigaltstack(&ss, nullptr);
+
+    _ctx.store(ctx);
+    _hook.store(h);
+    struct sigaction sa {};
+    sa.sa_sigaction = &LogCrash::handler;
+    sa.sa_flags     = SA_SIGINFO | SA_ONSTACK | SA_RESETHAND;
+    sigemptyset(&sa.sa_mask);
+    bool ok = true;
+    for (size_t i = 0; i < size(SIGNALS); ++i){
+        if (!terminate && (SIGNALS[i] == SIGTERM || SIGNALS[i] == SIGINT)){
+            continue;
+        }
+        _set[i] = sigaction(SIGNALS[i], &sa, &_prev[i]) == 0;
+        ok = ok && _set[i];
+    }
+    return ok;
+}
+
+void LogCrash::uninstall(){
+    for (size_t i = 0; i < size(SIGNALS); ++i){
+        if (_set[i]){
+            sigaction(SIGNALS[i], &_prev[i], nullptr);
+            _set[i] = false;
+        }
+    }
+    _hook.store(nullptr);
+    _ctx.store(nullptr);
+}
+
+void LogCrash::handler(int sig, siginfo_t* info, void*){
+    if (_active.exchange(true)){
+        signal(sig, SIG_DFL);                                                       ///> fault inside the handler or a second thread
+        raise(sig);
+        return;
+    }
+    int saved = errno;
+    {
+        timespec ts {};
+        clock_gettime(CLOCK_REALTIME, &ts);
+        LogEmergency e;
+        e << "*** " << name(sig) << " (" << sig << ")";
+        if (sig == SIGSEGV || sig == SIGBUS || sig == SIGILL || sig == SIGFPE){
+            e << " at " << (info ? info->si_addr : nullptr);
+        }
+        e << ", pid " << static_cast<int64_t>(getpid()) << ", tid " << static_cast<int64_t>(::syscall(SYS_gettid))
+          << ", time " << static_cast<int64_t>(ts.tv_sec) << '.';
+        long ms = ts.tv_nsec / 1000000;
+        e << static_cast<char>('0' + ms / 100) << static_cast<char>('0' + ms / 10 % 10) << static_cast<char>('0' + ms % 10) << " ***";
+    }
+#if defined(__GLIBC__)
+    void* frames[64];
+    int n = backtrace(frames, 64);
+    backtrace_symbols_fd(frames, n, LogEmergency::get_fd());
+#endif
+    if (hook h = _hook.load()){
+        h(_ctx.load());
+    }
+    errno = saved;
+    raise(sig);                                                                     ///> SA_RESETHAND: default action now
+}
+
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include <unistd.h>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogEmergency                                                                                                    //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Async-signal-safe line writer for crash paths
+*   - fixed buffer inside the object (no heap), integer-only formatting, one write(2) per line on destruction
+*   - no locks, no locale, no stdio: usable from signal handlers and with a corrupted heap
+*   - longer lines are cut at CAPACITY - 1 bytes
+*/
+class LogEmergency{
+public:
+    static constexpr size_t CAPACITY = 1024;
+
+    inline              LogEmergency            () = default;
+    inline explicit     LogEmergency            (bool _w) : _write(_w) {}           ///> false: only format, take the text with line()
+    inline              LogEmergency            (const LogEmergency&)       = delete;
+    inline              LogEmergency& operator= (const LogEmergency&)       = delete;
+    inline              ~LogEmergency           () { if (_write) { _buf[_n++] = '\n'; write_all(_buf, _n); } }
+
+    LogEmergency&       operator<<              (const char*);
+    LogEmergency&       operator<<              (char);
+    inline LogEmergency& operator<<             (bool v) { return *this << (v ? "true" : "false"); }
+    LogEmergency&       operator<<              (double);                           ///> 3 decimals, integer math
+    LogEmergency&       operator<<              (const void*);                      ///> 0x... hex
+    template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    inline LogEmergency& operator<<             (T);
+    LogEmergency&       append                  (const char*, size_t);
+    inline std::string_view line                () { _buf[_n] = '\n'; return {_buf, _n + 1}; } ///> Text so far with its '\n'
+
+    static inline void  set_fd                  (int fd) { _fd.store(fd, std::memory_order_relaxed); } ///> Target descriptor (default stderr)
+    static inline int   get_fd                  () { return _fd.load(std::memory_order_relaxed); }
+    static void         write_all               (const char*, size_t);              ///> write(2) until done, retry on EINTR
+
+private:
+    inline static std::atomic<int> _fd          {STDERR_FILENO};
+    char                _buf[CAPACITY];
+    size_t              _n                      {0};
+    bool                _write                  {true};
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogCrash                                                                                                        //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Fatal signal handlers: SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT (+ optional SIGTERM, SIGINT)
+*   - report signal, fault address, pid/tid & a backtrace with LogEmergency, run the flush hook,
+*     then re-raise with the default action (core dumps & exit codes are kept)
+*   - on the installing thread handlers run on a preallocated alternate stack, so its stack overflow is reported too
+*   - a second fatal signal while handling dies right away
+*/
+class LogCrash{
+public:
+    using hook = void (*)(void*);
+
+    static bool         install                 (hook, void*, bool terminate = false);  ///> Replace handlers (terminate: also SIGTERM/SIGINT)
+    static void         uninstall               ();                                 ///> Restore previous handlers
+    static inline bool  installed               (void* ctx) { return _ctx.load() == ctx && _hook.load() != nullptr; }
+
+private:
+    static void         handler                 (int, siginfo_t*, void*);
+    static const char*  name                    (int);
+
+    static constexpr int SIGNALS[]              {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT, SIGTERM, SIGINT};
+    static constexpr size_t STACK               = 64 << 10;
+
+    inline static std::atomic<hook> _hook       {nullptr};
+    inline static std::atomic<void*> _ctx       {nullptr};
+    inline static std::atomic<bool> _active     {false};                            ///> a handler is running
+    static struct sigaction     _prev[];                                            ///> per SIGNALS entry
+    static bool                 _set[];
+    static char                 _stack[];
+};
+
+
+
+template <class T, std::enable_if_t<std::is_integral_v<T>, int>>
+LogEmergency& LogEmergency::operator<<(T v){
+    char tmp[24];
+    size_t i = sizeof(tmp);
+    bool neg = false;
+    uint64_t u;
+    if constexpr (std::is_signed_v<T>){
+        neg = v < 0;
+        u   = neg ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+    }
+    else{
+        u = static_cast<uint64_t>(v);
+    }
+    do{
+        tmp[--i] = static_cast<char>('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (neg){
+        tmp[--i] = '-';
+    }
+    return append(tmp + i, sizeof(tmp) - i);
+}
+
+}
@@ -0,0 +1,246 @@
+#include <LogFile.hpp>
+
+#include <algorithm>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace chrono;
+
+namespace cpp_up{
+
+FileSink::FileSink(const string& _p, const config& _c)
+    : FileSink(_p, _c, true)
+{
+}
+
+FileSink::FileSink(const string& _p, const config& _c, bool _start)
+    : _path(_p), _cfg(_c)
+{
+    _front.reserve(_cfg.flush_bytes + (_cfg.flush_bytes >> 2));
+    _back.reserve(_front.capacity());
+    open();
+    schedule_rotation(system_clock::now());
+    if (_start){
+        start();
+    }
+}
+
+void FileSink::start(){
+    _io = thread(&FileSink::io_loop, this);
+}
+
+FileSink::~FileSink(){
+    stop_io();
+    if (_file){
+        fclose(_file);
+    }
+    int fd = _fd.exchange(-1);
+    if (fd >= 0 && !_fd_busy.load()){
+        ::close(fd);
+    }
+}
+
+void FileSink::stop_io(){
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+    }
+    _io_cv.notify_one();
+    if (_io.joinable()){
+        _io.join();
+    }
+}
+
+void FileSink::write(const char* p, size_t n, unsigned level){
+    unique_lock<mutex> lock(_mutex);
+    if (_front.size() > _cfg.max_pending){
+        _kick = true;                                                               ///> no timer may be running (flush_interval 0)
+        _io_cv.notify_one();
+        _done_cv.wait(lock, [this]{ return _front.size() <= _cfg.max_pending || _stop; });
+    }
+    _front.append(p, n);
+    if (_front.size() >= _cfg.flush_bytes || level <= _cfg.flush_level){
+        _kick = true;
+        lock.unlock();
+        _io_cv.notify_one();
+    }
+}
+
+void FileSink::flush(){
+    unique_lock<mutex> lock(_mutex);
+    uint64_t target = ++_flush_req;
+    _kick = true;
+    _io_cv.notify_one();
+    _done_cv.wait(lock, [this, target]{ return _flush_done >= target || _stop; });
+}
+
+void FileSink::emergency_flush(){
+    if (!_mutex.try_lock()){
+        return;                                                                     ///> held by the crashing thread or mid-swap
+    }
+    _fd_busy.store(true);                                                           ///> stays set: rotation no longer closes a published fd
+    int fd = _fd.load();
+    size_t done = 0;
+    while (fd >= 0 && done < _front.size()){
+        ssize_t w = ::write(fd, _front.data() + done, _front.size() - done);
+        if (w < 0 && errno == EINTR){
+            continue;
+        }
+        if (w <= 0){
+            break;
+        }
+        done += static_cast<size_t>(w);
+    }
+    _front.erase(0, done);
+    _mutex.unlock();
+}
+
+bool FileSink::emergency_write(const char* p, size_t n){
+    _fd_busy.store(true);
+    int fd = _fd.load();
+    if (fd < 0){
+        return false;
+    }
+    while (n > 0){
+        ssize_t w = ::write(fd, p, n);
+        if (w < 0 && errno == EINTR){
+            continue;
+        }
+        if (w <= 0){
+            break;
+        }
+        p += w;
+        n -= static_cast<size_t>(w);
+    }
+    return true;
+}
+
+void FileSink::configure(const config& _c){
+    lock_guard<mutex> lock(_mutex);
+    _cfg = _c;
+    schedule_rotation(system_clock::now());
+    _kick = true;
+    _io_cv.notify_one();
+}
+
+void FileSink::io_loop(){
+    open();                                                                         ///> before the first wait: the crash path has an fd
+    unique_lock<mutex> lock(_mutex);
+    for (;;){
+        bool timed = _cfg.flush_interval > milliseconds(0);                         ///> 0: only kicks, stop & rotation wake it
+        milliseconds wait = _cfg.flush_interval;
+        if (_next_rotation != system_clock::time_point::max()){
+            milliseconds due = duration_cast<milliseconds>(_next_rotation - system_clock::now()) + milliseconds(1);
+            wait  = timed ? min(wait, due) : due;
+            timed = true;
+        }
+        if (!timed){
+            _io_cv.wait(lock, [this]{ return _kick || _stop; });
+        }
+        else if (wait > milliseconds(0)){
+            _io_cv.wait_for(lock, wait, [this]{ return _kick || _stop; });
+        }
+        _kick = false;
+        bool stop = _stop;
+        uint64_t req = _flush_req;
+        swap(_front, _back);
+        bool time_rotation = system_clock::now() >= _next_rotation;
+        size_t rotate_bytes = _cfg.rotate_bytes;
+        unsigned keep = _cfg.max_files;
+        lock.unlock();
+
+        if (!_file){
+            open();                                                                 ///> retry: missing directory, EMFILE, ...
+        }
+        size_t written = 0;
+        if (!_back.empty() && _file){
+            written = fwrite(_back.data(), 1, _back.size(), _file);
+            _file_size += written;
+        }
+        if (written < _back.size()){
+            lose(_back.data() + written, _back.size() - written);
+        }
+        _back.clear();
+        if (time_rotation || (rotate_bytes != 0 && _file_size >= rotate_bytes)){
+            rotate(keep);
+        }
+
+        lock.lock();
+        if (time_rotation){
+            schedule_rotation(system_clock::now());
+        }
+        _flush_done = req;
+        _done_cv.notify_all();
+        if (stop && _front.empty()){
+            break;
+        }
+    }
+}
+
+void FileSink::lose(const char* p, size_t n){
+    uint64_t lines = static_cast<uint64_t>(count(p, p + n, '\n'));
+    _dropped.fetch_add(lines ? lines : 1, memory_order_relaxed);                    ///> a cut line counts once
+}
+
+void FileSink::open(){
+    _file = fopen(_path.c_str(), "ab");
+    _file_size = 0;
+    if (_file){
+        setvbuf(_file, nullptr, _IONBF, 0);                                        ///> buffering is done here
+        fseek(_file, 0, SEEK_END);
+        long pos = ftell(_file);
+        _file_size = pos > 0 ? static_cast<uint64_t>(pos) : 0;
+    }
+    publish_fd(_file ? fcntl(fileno(_file), F_DUPFD_CLOEXEC, 0) : -1);
+}
+
+void FileSink::publish_fd(int fd){
+    int old = _fd.exchange(fd);
+    if (old >= 0 && !_fd_busy.load()){                                              ///> seq_cst: a handler that saw old has set busy first
+        ::close(old);
+    }
+}
+
+void FileSink::rotate(unsigned keep){
+    if (_file_size == 0){
+        return;
+    }
+    if (_file){
+        fclose(_file);
+        _file = nullptr;
+    }
+    string done = archive(keep);
+    open();
+    if (!done.empty()){
+        rotated(done);
+    }
+}
+
+string FileSink::archive(unsigned keep){
+    if (keep == 0){
+        remove(_path.c_str());
+        return "";
+    }
+    remove((_path + "." + to_string(keep)).c_str());
+    for (unsigned i = keep - 1; i >= 1; --i){
+        rename((_path + "." + to_string(i)).c_str(), (_path + "." + to_string(i + 1)).c_str());
+    }
+    rename(_path.c_str(), (_path + ".1").c_str());
+    return _path + ".1";
+}
+
+void FileSink::schedule_rotation(system_clock::time_point now){
+    if (_cfg.rotate_interval <= seconds(0)){
+        _next_rotation = system_clock::time_point::max();
+        return;
+    }
+    ///> align to interval boundaries (e.g. full hours)
+    seconds since = duration_cast<seconds>(now.time_since_epoch());
+    seconds next  = (since / _cfg.rotate_interval + 1) * _cfg.rotate_interval;
+    _next_rotation = system_clock::time_point(next);
+}
+
+}
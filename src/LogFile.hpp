@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <LogSink.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  FileSink                                                                                                        //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Buffered log file with size/time based rotation
+*   - loggers only append into a large userspace buffer (front); an own I/O thread swaps it out (back),
+*     writes it with one fwrite and performs the rotation, so loggers never wait for the disk or a rename
+*   - flush triggers: buffered bytes, interval, or a line at/above a severity level (LOG_ERR is most severe)
+*   - rotation: 'log.txt' -> 'log.txt.1' -> ... -> 'log.txt.N' (oldest is removed)
+*   - a file that cannot be opened (or written) is retried every I/O cycle, the lines lost meanwhile are counted (dropped())
+*     (CompressedFileSink: compressed in the background, see LogCompress.hpp)
+*/
+class FileSink : public LogSink{
+public:
+    struct config{
+        size_t          flush_bytes             {1 << 20};                          ///> flush when this much is buffered
+        std::chrono::milliseconds flush_interval {1000};                            ///> flush at least this often (0 = no periodic flush)
+        unsigned        flush_level             {1};                                ///> flush right away for LOG_ERR/LOG_WARN
+        size_t          rotate_bytes            {0};                                ///> 0 = no size rotation
+        std::chrono::seconds rotate_interval    {0};                                ///> 0 = no time rotation
+        unsigned        max_files               {5};                                ///> rotated files kept next to the live one
+        size_t          max_pending             {64 << 20};                         ///> loggers wait beyond this backlog
+    };
+
+    /*
+    *   Construct
+    */
+                        FileSink                (const std::string&, const config&);
+    inline              FileSink                (FileSink& _src)        = delete;   ///> Copy semantics
+    inline              FileSink& operator=     (FileSink const&)       = delete;
+                        ~FileSink               () override;                        ///> Write everything & close
+
+    /*
+    *   SYSTEM CONTROL
+    */
+    void                write                   (const char*, size_t, unsigned) override;
+    void                flush                   () override;                        ///> Wait until buffered data is written
+    void                emergency_flush         () override;                        ///> write(2) the front buffer to the published fd unless it is locked
+    bool                emergency_write         (const char*, size_t) override;     ///> write(2) to the published fd, false while no file is open
+    void                configure               (const config&);
+    inline const std::string& path              () const { return _path; }
+    inline bool         is_open                 () const { return _fd.load(std::memory_order_relaxed) >= 0; }
+    inline uint64_t     dropped                 () const { return _dropped.load(std::memory_order_relaxed); } ///> Lines not written: file not open, write error
+
+protected:
+                        FileSink                (const std::string&, const config&, bool); ///> false: the derived constructor calls start()
+    void                start                   ();                                 ///> Start the I/O thread (it calls the virtual archive/rotated)
+    virtual void        rotated                 (const std::string&) {}             ///> Called on the I/O thread with the path of a finished file
+    virtual std::string archive                 (unsigned);                         ///> Move the closed live file away, return its new path ("" = dropped)
+    void                stop_io                 ();                                 ///> Write the rest & join the I/O thread (derived destructors call it first)
+
+private:
+    void                io_loop                 ();
+    void                open                    ();
+    void                publish_fd              (int);                              ///> Swap the emergency fd (I/O thread)
+    void                lose                    (const char*, size_t);              ///> Count the lines of an unwritten buffer part
+    void                rotate                  (unsigned);                         ///> Shift files, keep N rotated ones
+    void                schedule_rotation       (std::chrono::system_clock::time_point);
+
+    std::string         _path;
+    config              _cfg;
+    FILE*               _file                   {nullptr};                          ///> I/O thread only
+    std::atomic<int>    _fd                     {-1};                               ///> dup of the live file: the only thing emergency_flush() touches
+    std::atomic<bool>   _fd_busy                {false};                            ///> emergency_flush() ran: published fds are never closed
+    uint64_t            _file_size              {0};
+    std::atomic<uint64_t> _dropped              {0};
+    std::chrono::system_clock::time_point _next_rotation {std::chrono::system_clock::time_point::max()};
+
+    std::string         _front;                                                     ///> filled by loggers
+    std::string         _back;                                                      ///> written by I/O thread
+    std::mutex          _mutex;
+    std::condition_variable _io_cv;
+    std::condition_variable _done_cv;
+    bool                _kick                   {false};
+    bool                _stop                   {false};
+    uint64_t            _flush_req              {0};
+    uint64_t            _flush_done             {0};
+    std::thread         _io;
+};
+
+}
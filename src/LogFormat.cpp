@@ -0,0 +1,60 @@
+#include <LogFormat.hpp>
+
+#include <ostream>
+#include <streambuf>
+
+using namespace std;
+
+namespace cpp_up{
+
+/*
+*   Stream buffer that appends into the string of the current value
+*/
+class LogStreamBuf : public streambuf{
+public:
+    inline void         target                  (string* s) { _s = s; }
+
+protected:
+    inline int_type     overflow                (int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())){
+            _s->push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+    inline streamsize   xsputn                  (const char* p, streamsize n) override {
+        _s->append(p, static_cast<size_t>(n));
+        return n;
+    }
+
+private:
+    string*             _s                      {nullptr};
+};
+
+struct LogFormatStream{
+    LogStreamBuf        buf;
+    ostream             os                      {&buf};
+    ios_base::fmtflags  flags                   {os.flags()};
+    streamsize          precision               {os.precision()};
+};
+
+static LogFormatStream& format_stream(){
+    static thread_local LogFormatStream s;
+    return s;
+}
+
+ostream& log_format_begin(string& out){
+    LogFormatStream& s = format_stream();
+    s.buf.target(&out);
+    return s.os;
+}
+
+void log_format_end(ostream& os){
+    LogFormatStream& s = format_stream();
+    os.clear();
+    os.flags(s.flags);
+    os.precision(s.precision);
+    os.width(0);
+    os.fill(' ');
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <charconv>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogFormat                                                                                                       //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Per-thread fallback stream for user types with operator<< (LogFormat.cpp, keeps <ostream> out of this header)
+*   - log_format_begin(): the stream, appending straight into out (no intermediate copy)
+*   - log_format_end()  : restores the format state, so each value starts from default flags (as a fresh stream would)
+*/
+std::ostream&           log_format_begin        (std::string& out);
+void                    log_format_end          (std::ostream&);
+
+/*
+*   Append one value to a log line without heap allocations in steady state
+*   - integers & floats : to_chars (floats keep the ostream default: general, 6 digits; int8_t/uint8_t are numbers,
+*                         only plain char is a character)
+*   - text              : direct append
+*   - everything else   : operator<< into the reused per-thread stream
+*/
+template <class T>
+inline void log_append(std::string& out, const T& v){
+    if constexpr (std::is_same_v<T, bool>){
+        out.push_back(v ? '1' : '0');
+    }
+    else if constexpr (std::is_same_v<T, char>){
+        out.push_back(v);
+    }
+    else if constexpr (std::is_integral_v<T>){
+        char buf[24];
+        std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, static_cast<size_t>(r.ptr - buf));
+    }
+    else if constexpr (std::is_floating_point_v<T>){
+        char buf[64];
+        std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::general, 6);
+        out.append(buf, static_cast<size_t>(r.ptr - buf));
+    }
+    else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>){
+        if (v != nullptr){
+            out.append(v);
+        }
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>){
+        out.append(std::string_view(v));
+    }
+    else{
+        std::ostream& os = log_format_begin(out);
+        os << v;
+        log_format_end(os);
+    }
+}
+
+}
@@ -0,0 +1,164 @@
+#include <LogJson.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CPP_UP_LOG_SIMD     1
+#else
+#define CPP_UP_LOG_SIMD     0
+#endif
+
+using namespace std;
+
+namespace cpp_up{
+
+static size_t scan_scalar(const char* p, size_t n){
+    for (size_t i = 0; i < n; ++i){
+        unsigned char c = static_cast<unsigned char>(p[i]);
+        if (c < 0x20 || c == '"' || c == '\\'){
+            return i;
+        }
+    }
+    return n;
+}
+
+#if CPP_UP_LOG_SIMD
+static size_t scan_sse2(const char* p, size_t n){
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i slash = _mm_set1_epi8('\\');
+    const __m128i ctrl  = _mm_set1_epi8(0x1F);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16){
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash)),
+                                 _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl));     ///> unsigned v <= 0x1F
+        unsigned bits = static_cast<unsigned>(_mm_movemask_epi8(m));
+        if (bits){
+            return i + static_cast<size_t>(__builtin_ctz(bits));
+        }
+    }
+    return i + scan_scalar(p + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_avx2(const char* p, size_t n){
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i slash = _mm256_set1_epi8('\\');
+    const __m256i ctrl  = _mm256_set1_epi8(0x1F);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32){
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash)),
+                                    _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl), ctrl));
+        unsigned bits = static_cast<unsigned>(_mm256_movemask_epi8(m));
+        if (bits){
+            return i + static_cast<size_t>(__builtin_ctz(bits));
+        }
+    }
+    _mm256_zeroupper();                                                             ///> not emitted for a file-local callee; dirty upper halves stall legacy SSE
+    return i + scan_sse2(p + i, n - i);
+}
+#endif
+
+unsigned LogJson::best(){
+#if CPP_UP_LOG_SIMD
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? AVX2 : SSE2;
+#else
+    return SCALAR;
+#endif
+}
+
+LogJson::scan_fn LogJson::pick(unsigned i){
+#if CPP_UP_LOG_SIMD
+    if (i == AVX2){
+        return &scan_avx2;
+    }
+    if (i == SSE2){
+        return &scan_sse2;
+    }
+#endif
+    return &scan_scalar;
+}
+
+size_t LogJson::scan_first(const char* p, size_t n){
+    get_isa();
+    return scan(p, n);
+}
+
+unsigned LogJson::set_isa(unsigned i){
+    i = min(i, best());
+    _isa.store(i, memory_order_relaxed);
+    _scan.store(pick(i), memory_order_relaxed);
+    return i;
+}
+
+unsigned LogJson::get_isa(){
+    if (_scan.load(memory_order_relaxed) == &LogJson::scan_first){
+        set_isa(AVX2);
+    }
+    return _isa.load(memory_order_relaxed);
+}
+
+void LogJson::escape(string& out, string_view s){
+    static const char hex[] = "0123456789abcdef";
+    const char* p = s.data();
+    size_t n      = s.size();
+    while (n > 0){
+        size_t i = scan(p, n);
+        out.append(p, i);
+        if (i == n){
+            return;
+        }
+        char c = p[i];
+        switch (c){
+            case '"':   out.append("\\\"", 2); break;
+            case '\\':  out.append("\\\\", 2); break;
+            case '\n':  out.append("\\n", 2); break;
+            case '\r':  out.append("\\r", 2); break;
+            case '\t':  out.append("\\t", 2); break;
+            case '\b':  out.append("\\b", 2); break;
+            case '\f':  out.append("\\f", 2); break;
+            default:{
+                char u[6] = {'\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF]};
+                out.append(u, 6);
+            }
+        }
+        p += i + 1;
+        n -= i + 1;
+    }
+}
+
+void LogJson::quote(string& out, string_view s){
+    out.push_back('"');
+    escape(out, s);
+    out.push_back('"');
+}
+
+void LogJson::fields_text(string& out, string_view f){
+    LogFields::for_each(f, [&](char t, string_view k, string_view v){
+        out.push_back(' ');
+        out.append(k).push_back('=');
+        if (t == LogFields::STRING && (v.empty() || v.find_first_of(" =") != string_view::npos || scan(v.data(), v.size()) != v.size())){
+            quote(out, v);
+        }
+        else{
+            out.append(v);
+        }
+    });
+}
+
+void LogJson::fields_json(string& out, string_view f){
+    LogFields::for_each(f, [&](char t, string_view k, string_view v){
+        out.push_back(',');
+        quote(out, k);
+        out.push_back(':');
+        if (t == LogFields::STRING){
+            quote(out, v);
+        }
+        else{
+            out.append(v);
+        }
+    });
+}
+
+}
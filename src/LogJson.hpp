@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+
+#include <LogKV.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogJson                                                                                                         //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   JSON string escaping & the JSON / text form of LogRecord::fields (LogKV.hpp)
+*   - escape(): finds the next byte to escape ('"', '\\', < 0x20) 32 (AVX2) or 16 (SSE2) bytes at a time,
+*     clean runs are appended in bulk; bytes >= 0x80 pass as they are (UTF-8 text is expected)
+*   - the scanner is picked on first use from the CPU (AVX2 > SSE2 > scalar), set_isa() overrides it
+*/
+class LogJson{
+public:
+    enum isa : unsigned{
+        SCALAR              = 0,
+        SSE2                = 1,
+        AVX2                = 2
+    };
+
+    static void             escape              (std::string&, std::string_view);   ///> Append escaped text (no quotes)
+    static void             quote               (std::string&, std::string_view);   ///> Append "escaped text"
+    static inline size_t    scan                (const char* p, size_t n) { return _scan.load(std::memory_order_relaxed)(p, n); } ///> First byte to escape, n = none
+    static unsigned         set_isa             (unsigned);                         ///> Capped at what the CPU has, returns the one used
+    static unsigned         get_isa             ();
+
+    static void             fields_text         (std::string&, std::string_view);   ///> ' key=value' (strings with blanks/'='/'"' quoted)
+    static void             fields_json         (std::string&, std::string_view);   ///> ',"key":value'
+
+private:
+    using scan_fn = size_t (*)(const char*, size_t);
+
+    static size_t           scan_first          (const char*, size_t);              ///> Picks the scanner, then scans
+    static scan_fn          pick                (unsigned);                         ///> Scalar/SSE2/AVX2 scanner
+    static unsigned         best                ();
+
+    inline static std::atomic<scan_fn> _scan    {&LogJson::scan_first};
+    inline static std::atomic<unsigned> _isa    {SCALAR};
+};
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <LogFormat.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogKV                                                                                                           //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Typed key/value field of a log statement: LOG_MSG(LOG_INFO) << "login" << log_kv("user", name) << log_kv("ms", 12);
+*   - text lines get ' user=alice ms=12' after the message, JSON lines get "user":"alice","ms":12
+*   - binary mode records fields as text of the message
+*/
+template <class T>
+struct LogKV{
+    std::string_view    key;
+    const T&            value;
+};
+
+template <class T>
+inline LogKV<T> log_kv(std::string_view key, const T& value){
+    return {key, value};
+}
+
+template <class T, class C>
+inline std::basic_ostream<C>& operator<<(std::basic_ostream<C>& os, const LogKV<T>& kv){   ///> C: stream stays a dependent type (<iosfwd> only)
+    if constexpr (std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>){
+        return os << ' ' << kv.key << '=' << static_cast<int>(kv.value);
+    }
+    else{
+        return os << ' ' << kv.key << '=' << kv.value;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogFields                                                                                                       //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Encoding of LogRecord::fields, filled inline by the log_kv operands (LogJson renders it as text or JSON)
+*   - per field [type][key length u8][key][value length u32][value], values already in JSON number form
+*/
+class LogFields{
+public:
+    enum type : char{
+        STRING              = 's',
+        NUMBER              = 'n',
+        BOOL                = 'b'
+    };
+
+    template <class T>
+    static inline void      add                 (std::string&, std::string_view, const T&); ///> Append one field
+    template <class F>
+    static inline void      for_each            (std::string_view, F&&);            ///> f(type, key, value)
+};
+
+
+
+template <class T>
+void LogFields::add(std::string& f, std::string_view key, const T& v){
+    key = key.substr(0, 255);
+    size_t at = f.size();
+    f.push_back(STRING);
+    f.push_back(static_cast<char>(key.size()));
+    f.append(key);
+    f.append(4, '\0');
+    size_t from = f.size();
+    if constexpr (std::is_same_v<T, bool>){
+        f[at] = BOOL;
+        f.append(v ? "true" : "false");
+    }
+    else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, char>){       ///> int8_t/uint8_t too (log_append)
+        f[at] = NUMBER;
+        log_append(f, v);
+    }
+    else if constexpr (std::is_floating_point_v<T>){
+        if (__builtin_isfinite(v)){
+            f[at] = NUMBER;                                                         ///> nan/inf have no JSON number form
+        }
+        log_append(f, v);
+    }
+    else{
+        log_append(f, v);
+    }
+    uint32_t len = static_cast<uint32_t>(f.size() - from);
+    memcpy(&f[from - 4], &len, 4);
+}
+
+template <class F>
+void LogFields::for_each(std::string_view f, F&& fn){
+    size_t i = 0;
+    while (i + 6 <= f.size()){
+        char t        = f[i];
+        size_t klen   = static_cast<unsigned char>(f[i + 1]);
+        std::string_view k = f.substr(i + 2, klen);
+        uint32_t vlen;
+        memcpy(&vlen, f.data() + i + 2 + klen, 4);
+        fn(t, k, f.substr(i + 6 + klen, vlen));
+        i += 6 + klen + vlen;
+    }
+}
+
+}
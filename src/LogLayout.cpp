@@ -0,0 +1,208 @@
+#include <LogLayout.hpp>
+
+#include <charconv>
+#include <cstring>
+
+#if defined(__linux__)
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#include <LogJson.hpp>
+#include <LogTty.hpp>
+
+using namespace std;
+using namespace chrono;
+
+namespace cpp_up{
+
+uint64_t log_thread_id(){
+    static thread_local uint64_t id = [](){
+#if defined(__linux__)
+        return static_cast<uint64_t>(::syscall(SYS_gettid));
+#else
+        static atomic<uint64_t> next {1};
+        return next.fetch_add(1, memory_order_relaxed);
+#endif
+    }();
+    return id;
+}
+
+LogLayout::LogLayout(const string& pattern, const array<string, 6>& colors, bool color, bool plain)
+    : _color(color && !plain), _plain(plain)
+{
+    for (unsigned l = 0; l < _prog.size(); ++l){
+        compile(pattern, colors, l, _prog[l]);
+    }
+}
+
+LogLayout LogLayout::json_lines(){
+    LogLayout l("", {}, false);
+    l._json = true;
+    return l;
+}
+
+void LogLayout::compile(const string& pattern, const array<string, 6>& colors, unsigned level, program& p){
+    static const array<const char*, 6> names  {"ERROR", "WARNING", "INFO", "TIME", "DONE", "DEBUG"};
+    static const array<const char*, 6> padded {"ERROR  ", "WARNING", "INFO   ", "TIME   ", "DONE   ", "DEBUG  "};
+    bool known = level < names.size();
+    bool body  = false;
+    size_t start = 0;
+
+    auto flush_text = [&](){
+        if (p.text.size() > start){
+            p.ops.push_back({OP_TEXT, static_cast<uint32_t>(start), static_cast<uint32_t>(p.text.size() - start)});
+        }
+        start = p.text.size();
+    };
+    auto dynamic = [&](op_type t, uint32_t off = 0, uint32_t len = 0){
+        flush_text();
+        p.ops.push_back({t, off, len});
+    };
+
+    for (size_t i = 0; i < pattern.size(); ++i){
+        if (pattern[i] != '%' || i + 1 == pattern.size()){
+            p.text.push_back(pattern[i]);
+            continue;
+        }
+        char c = pattern[++i];
+        switch (c){
+        case 'T': dynamic(OP_TIME); break;
+        case 'Y': dynamic(OP_DIGITS, 0, 4); break;
+        case 'm': dynamic(OP_DIGITS, 4, 2); break;
+        case 'd': dynamic(OP_DIGITS, 6, 2); break;
+        case 'H': dynamic(OP_DIGITS, 8, 2); break;
+        case 'M': dynamic(OP_DIGITS, 10, 2); break;
+        case 'S': dynamic(OP_DIGITS, 12, 2); break;
+        case 'e': dynamic(OP_MSEC); break;
+        case 'f': dynamic(OP_USEC); break;
+        case 'z': dynamic(OP_ZONE); break;
+        case 't': dynamic(OP_THREAD); break;
+        case 's': dynamic(OP_FILE); break;
+        case '#': dynamic(OP_LINE); break;
+        case '@': dynamic(OP_SITE); break;
+        case 'v': dynamic(OP_BODY); body = true; break;
+        case 'L': p.text.append(known ? padded[level] : "       "); break;
+        case 'l': p.text.append(known ? names[level] : ""); break;
+        case '^': p.text.append(known && _color ? colors[level] : ""); break;
+        case '$': p.text.append(_color ? "\033[0;0m" : ""); break;
+        case '%': p.text.push_back('%'); break;
+        default:  p.text.push_back('%'); p.text.push_back(c); break;
+        }
+    }
+    if (!body){
+        dynamic(OP_BODY);
+    }
+    flush_text();
+}
+
+const char* LogLayout::base_name(const char* f){
+    const char* b = strrchr(f, '/');
+    return b ? b + 1 : f;
+}
+
+void LogLayout::render(string& out, const LogRecord& r, LogTime& time) const{
+    if (_json){
+        render_json(out, r, time);
+        return;
+    }
+    const program& p = _prog[r.level < _prog.size() - 1 ? r.level : _prog.size() - 1];
+    char buf[24];
+    for (const op& o : p.ops){
+        switch (o.type){
+        case OP_TEXT:
+            out.append(p.text.data() + o.off, o.len);
+            break;
+        case OP_TIME:
+            time.append(out, r.time, _color);
+            break;
+        case OP_DIGITS:
+            out.append(time.at(r.time).digits + o.off, o.len);
+            break;
+        case OP_MSEC:
+        case OP_USEC:{
+            unsigned us = time.at(r.time).usec;
+            unsigned v  = o.type == OP_MSEC ? us / 1000 : us;
+            int w       = o.type == OP_MSEC ? 3 : 6;
+            for (int i = w - 1; i >= 0; --i){
+                buf[i] = static_cast<char>('0' + v % 10);
+                v /= 10;
+            }
+            out.append(buf, static_cast<size_t>(w));
+            break;
+        }
+        case OP_ZONE:
+            out.append(time.at(r.time).zone, sizeof(LogTime::stamp::zone));
+            break;
+        case OP_THREAD:{
+            to_chars_result res = to_chars(buf, buf + sizeof(buf), r.thread ? r.thread : log_thread_id());
+            out.append(buf, static_cast<size_t>(res.ptr - buf));
+            break;
+        }
+        case OP_FILE:
+            if (r.file) out.append(base_name(r.file));
+            break;
+        case OP_LINE:
+        case OP_SITE:{
+            if (!r.file) break;
+            if (o.type == OP_SITE){
+                out.append(base_name(r.file)).push_back(':');
+            }
+            to_chars_result res = to_chars(buf, buf + sizeof(buf), r.line);
+            out.append(buf, static_cast<size_t>(res.ptr - buf));
+            break;
+        }
+        case OP_BODY:
+            if (!_plain || !LogTty::has_escape(r.body)){
+                out.append(r.body);
+            }
+            else{
+                LogTty::strip(out, r.body);                                         ///> no terminal: drop user colors too
+            }
+            if (!r.fields.empty()){
+                LogJson::fields_text(out, r.fields);
+            }
+            break;
+        }
+    }
+}
+
+void LogLayout::render_json(string& out, const LogRecord& r, LogTime& time) const{
+    static const array<const char*, 6> names {"ERROR", "WARNING", "INFO", "TIME", "DONE", "DEBUG"};
+    const LogTime::stamp& st = time.at(r.time);
+    const char* d = st.digits;
+    char ts[40] = {'"', d[0], d[1], d[2], d[3], '-', d[4], d[5], '-', d[6], d[7], 'T',
+                   d[8], d[9], ':', d[10], d[11], ':', d[12], d[13], '.'};
+    unsigned us = st.usec;
+    for (int i = 26; i >= 21; --i){
+        ts[i] = static_cast<char>('0' + us % 10);
+        us /= 10;
+    }
+    memcpy(ts + 27, st.zone, sizeof(st.zone));
+    out.append("{\"time\":").append(ts, 33).append("\",\"level\":\"");
+    out.append(r.level < names.size() ? names[r.level] : "").append("\",\"thread\":");
+    char buf[24];
+    to_chars_result res = to_chars(buf, buf + sizeof(buf), r.thread ? r.thread : log_thread_id());
+    out.append(buf, static_cast<size_t>(res.ptr - buf));
+    if (r.file){
+        out.append(",\"file\":");
+        LogJson::quote(out, base_name(r.file));
+        out.append(",\"line\":");
+        res = to_chars(buf, buf + sizeof(buf), r.line);
+        out.append(buf, static_cast<size_t>(res.ptr - buf));
+    }
+    out.append(",\"msg\":");
+    if (LogTty::has_escape(r.body)){
+        static thread_local string plain;
+        plain.clear();
+        LogTty::strip(plain, r.body);
+        LogJson::quote(out, plain);
+    }
+    else{
+        LogJson::quote(out, r.body);
+    }
+    LogJson::fields_json(out, r.fields);
+    out.push_back('}');
+}
+
+}
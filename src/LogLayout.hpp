@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <LogTime.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogRecord                                                                                                       //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   One log line as handed from the call site to the layout
+*/
+struct LogRecord{
+    unsigned                    level;
+    std::chrono::system_clock::time_point time;
+    const char*                 file;                                               ///> nullptr if unknown
+    unsigned                    line;
+    std::string_view            body;
+    uint64_t                    thread          {0};                                ///> 0 = calling thread
+    std::string_view            fields          {};                                 ///> log_kv fields (LogJson encoding)
+};
+
+/*
+*   Id of the calling thread (kernel tid on Linux, sequential elsewhere), cached per thread
+*/
+uint64_t log_thread_id();
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogLayout                                                                                                       //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Line pattern compiled once into a render program per level
+*   - static text, level names & level colors are pre-rendered into one contiguous buffer per level,
+*     so rendering a line is a short list of memcpys plus the dynamic fields
+*
+*   %T  time module (as set by set_log_style_time_*)   %Y %m %d %H %M %S  date & time digits
+*   %e  milliseconds    %f  microseconds    %z  zone offset (+hh:mm)
+*   %L  level name (padded)     %l  level name      %^  level color     %$  reset color (both empty without colors)
+*   %t  thread id       %s  source file     %#  source line     %@  file:line
+*   %v  message & log_kv fields (appended at the end if absent; plain layouts strip escapes from the message)
+*   %%  literal '%'
+*
+*   json_lines(): one JSON object per line instead of a pattern:
+*   {"time":"2026-10-17T14:36:25.123456+02:00","level":"INFO","thread":4242,"file":"main.cpp","line":80,"msg":"...",<fields>}
+*/
+class LogLayout{
+public:
+    /*
+    *   Construct
+    */
+                        LogLayout               (const std::string&, const std::array<std::string, 6>&, bool color, bool plain = false); ///> plain: for non-terminal sinks
+    static LogLayout    json_lines              ();                                 ///> JSON Lines, zone as set by the time format
+
+    /*
+    *   SYSTEM CONTROL
+    */
+    void                render                  (std::string&, const LogRecord&, LogTime&) const; ///> Append rendered line (without '\n')
+
+private:
+    enum op_type : uint8_t{
+        OP_TEXT,                                                                    ///> off/len into program text
+        OP_TIME,
+        OP_DIGITS,                                                                  ///> off/len into LogTime::stamp::digits
+        OP_MSEC,
+        OP_USEC,
+        OP_ZONE,
+        OP_THREAD,
+        OP_FILE,
+        OP_LINE,
+        OP_SITE,
+        OP_BODY
+    };
+    struct op{
+        op_type         type;
+        uint32_t        off;
+        uint32_t        len;
+    };
+    struct program{
+        std::string     text;
+        std::vector<op> ops;
+    };
+
+    void                compile                 (const std::string&, const std::array<std::string, 6>&, unsigned, program&);
+    void                render_json             (std::string&, const LogRecord&, LogTime&) const;
+    static const char*  base_name               (const char*);
+
+    std::array<program, 7> _prog;                                                   ///> one per level + unknown level
+    bool                _color;
+    bool                _plain;                                                     ///> strip escapes of the message
+    bool                _json                   {false};
+};
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <LogClock.hpp>
+#include <LogSite.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogLimit                                                                                                        //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Call-site limiters used by LOG_EVERY_N / LOG_FIRST_N / LOG_RATE
+*   - state lives in the static LogSite of the statement, checked with relaxed atomics before any formatting
+*   - a suppressed call only bumps LogSite::skipped; the next emitted line takes & reports that count
+*/
+
+/*
+*   Pass the 1st, (N+1)th, (2N+1)th ... call
+*/
+inline bool log_every_n(LogSite& site, uint64_t n){
+    if (n <= 1 || site.hits.fetch_add(1, std::memory_order_relaxed) % n == 0){
+        return true;
+    }
+    site.skipped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/*
+*   Pass the first N calls (later calls are not counted: no line would report them)
+*/
+inline bool log_first_n(LogSite& site, uint64_t n){
+    return site.hits.load(std::memory_order_relaxed) < n && site.hits.fetch_add(1, std::memory_order_relaxed) < n;
+}
+
+/*
+*   Pass at most K calls per second, bursts of up to K (token bucket as GCRA: one CAS on a timestamp)
+*   - K < 1 passes one call every 1/K seconds
+*/
+inline bool log_rate(LogSite& site, double per_sec){
+    if (per_sec <= 0){
+        return false;
+    }
+    int64_t step = static_cast<int64_t>(1e9 / per_sec);
+    step = step < 1 ? 1 : step;
+    const int64_t window = step > 1000000000 ? step : 1000000000;                  ///> below 1/s: a burst of one
+    int64_t now  = static_cast<int64_t>(LogClock::now());
+    int64_t tat  = site.tat.load(std::memory_order_relaxed);
+    for (;;){
+        int64_t t = tat > now ? tat : now;
+        if (t - now > window - step){
+            site.skipped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (site.tat.compare_exchange_weak(tat, t + step, std::memory_order_relaxed)){
+            return true;
+        }
+    }
+}
+
+}
@@ -0,0 +1,154 @@
+#include <LogMmap.hpp>
+
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace cpp_up{
+
+MmapSink::MmapSink(const string& _path, size_t _segment)
+    : _seg(_segment)
+{
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    _seg = (_seg + page - 1) / page * page;
+    _fd = ::open(_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (_fd < 0){
+        return;
+    }
+    _offset.store(find_end(), memory_order_relaxed);
+    map_segment(_offset.load(memory_order_relaxed) / _seg);
+}
+
+MmapSink::~MmapSink(){
+    if (_fd < 0){
+        return;
+    }
+    for (slot& s : _slots){
+        if (s.base){
+            munmap(s.base, _seg);
+        }
+    }
+    if (ftruncate(_fd, static_cast<off_t>(_offset.load())) != 0){
+        ///> keep the zero-filled tail, readers skip it
+    }
+    ::close(_fd);
+}
+
+uint64_t MmapSink::find_end(){
+    struct stat st;
+    if (fstat(_fd, &st) != 0 || st.st_size == 0){
+        return 0;
+    }
+    ///> a crashed writer leaves a zero-filled tail: scan back to the last written byte
+    char buf[1 << 16];
+    off_t end = st.st_size;
+    while (end > 0){
+        off_t from = end > static_cast<off_t>(sizeof(buf)) ? end - static_cast<off_t>(sizeof(buf)) : 0;
+        ssize_t n = pread(_fd, buf, static_cast<size_t>(end - from), from);
+        if (n <= 0){
+            break;
+        }
+        for (ssize_t i = n - 1; i >= 0; --i){
+            if (buf[i] != '\0'){
+                return static_cast<uint64_t>(from + i + 1);
+            }
+        }
+        end = from;
+    }
+    return 0;
+}
+
+bool MmapSink::map_slot(uint64_t k){
+    slot& s = _slots[k % _slots.size()];
+    uint64_t held = s.seg.load();
+    if (held == k){
+        return true;
+    }
+    if (held != UINT64_MAX && held > k){
+        return false;                                                               ///> slot moved on
+    }
+    off_t end = static_cast<off_t>((k + 1) * _seg);
+    if (posix_fallocate(_fd, static_cast<off_t>(k * _seg), static_cast<off_t>(_seg)) != 0){
+        struct stat st;
+        if (fstat(_fd, &st) != 0 || (st.st_size < end && ftruncate(_fd, end) != 0)){
+            return false;
+        }
+    }
+    void* p = mmap(nullptr, _seg, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, static_cast<off_t>(k * _seg));
+    if (p == MAP_FAILED){
+        return false;
+    }
+
+    ///> evict the old segment once no writer copies into it
+    s.seg.store(UINT64_MAX);
+    while (s.users.load() != 0){
+        this_thread::yield();
+    }
+    if (s.base){
+        msync(s.base, _seg, MS_ASYNC);
+        munmap(s.base, _seg);
+    }
+    s.base = static_cast<char*>(p);
+    s.seg.store(k);
+    return true;
+}
+
+bool MmapSink::map_segment(uint64_t k){
+    lock_guard<mutex> lock(_mutex);
+    bool ok = map_slot(k);
+    map_slot(k + 1);                                                                ///> map ahead
+    return ok;
+}
+
+void MmapSink::write_part(uint64_t k, size_t at, const char* p, size_t n){
+    slot& s = _slots[k % _slots.size()];
+    for (;;){
+        s.users.fetch_add(1);
+        if (s.seg.load() == k){
+            memcpy(s.base + at, p, n);
+            s.users.fetch_sub(1, memory_order_release);
+            return;
+        }
+        s.users.fetch_sub(1, memory_order_release);
+        if (!map_segment(k)){
+            ///> segment already evicted (very late writer) or mapping failed: plain positioned write
+            if (pwrite(_fd, p, n, static_cast<off_t>(k * _seg + at)) < 0){
+                return;
+            }
+            return;
+        }
+    }
+}
+
+void MmapSink::write(const char* p, size_t n, unsigned){
+    if (_fd < 0 || n == 0){
+        return;
+    }
+    uint64_t off = _offset.fetch_add(n, memory_order_relaxed);
+    while (n > 0){
+        uint64_t k  = off / _seg;
+        size_t at   = static_cast<size_t>(off % _seg);
+        size_t part = min(n, _seg - at);
+        write_part(k, at, p, part);
+        off += part;
+        p   += part;
+        n   -= part;
+    }
+}
+
+void MmapSink::flush(){
+    lock_guard<mutex> lock(_mutex);
+    for (slot& s : _slots){
+        if (s.base){
+            msync(s.base, _seg, MS_ASYNC);
+        }
+    }
+}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <LogSink.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  MmapSink                                                                                                        //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Log file written through preallocated, memory-mapped segments
+*   - a line is appended with one atomic offset reservation + memcpy, no syscall (safe for concurrent writers)
+*   - the file grows by whole segments; the next segment is mapped ahead, so only the writer that crosses
+*     a boundary pays for a mapping
+*   - mapped pages belong to the page cache: every line copied before a process crash is in the file
+*     (the preallocated tail is zero-filled until the file is closed and truncated to its real length)
+*/
+class MmapSink : public LogSink{
+public:
+    /*
+    *   Construct
+    */
+                        MmapSink                (const std::string&, size_t segment = 64 << 20);
+    inline              MmapSink                (MmapSink& _src)        = delete;   ///> Copy semantics
+    inline              MmapSink& operator=     (MmapSink const&)       = delete;
+                        ~MmapSink               () override;                        ///> Unmap & truncate to real length
+
+    /*
+    *   SYSTEM CONTROL
+    */
+    void                write                   (const char*, size_t, unsigned) override;
+    void                flush                   () override;                        ///> Schedule write-back of mapped pages
+    inline bool         is_open                 () const { return _fd >= 0; }
+    inline uint64_t     size                    () const { return _offset.load(std::memory_order_relaxed); }
+
+private:
+    struct slot{
+        std::atomic<uint64_t> seg               {UINT64_MAX};                       ///> segment index held by this slot
+        std::atomic<uint32_t> users             {0};                                ///> writers copying into it
+        char*           base                    {nullptr};
+    };
+
+    void                write_part              (uint64_t, size_t, const char*, size_t);   ///> Copy into one segment
+    bool                map_segment             (uint64_t);                         ///> Map segment (+ the next one), false if evicted already
+    bool                map_slot                (uint64_t);
+    uint64_t            find_end                ();                                 ///> Real length of an existing file
+
+    int                 _fd                     {-1};
+    size_t              _seg;
+    std::atomic<uint64_t> _offset               {0};
+    std::array<slot, 4> _slots;
+    std::mutex          _mutex;                                                     ///> mapping changes only
+};
+
+}
@@ -0,0 +1,156 @@
+#include <LogProfile.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <unordered_map>
+
+using namespace std;
+
+namespace cpp_up{
+
+void log_append_ns(string& out, double ns){
+    static const char* units[] {"ns", "us", "ms", "s"};
+    unsigned u = 0;
+    while (u < 3 && ns >= 1000.0){
+        ns /= 1000.0;
+        ++u;
+    }
+    char buf[32];
+    to_chars_result r = to_chars(buf, buf + sizeof(buf), ns, chars_format::general, 3);
+    out.append(buf, static_cast<size_t>(r.ptr - buf)).append(units[u]);
+}
+
+struct LogTimer::registry{
+    mutex                                   mtx;
+    unordered_map<string, LogTimer*>        by_name;
+};
+
+uint64_t LogHistogram::lower(unsigned i){
+    if (i < SUB){
+        return i;
+    }
+    unsigned e = i / SUB + SUB_BITS - 1;
+    return (static_cast<uint64_t>(SUB + i % SUB)) << (e - SUB_BITS);
+}
+
+uint64_t LogHistogram::upper(unsigned i){
+    if (i < SUB){
+        return i;
+    }
+    unsigned e = i / SUB + SUB_BITS - 1;
+    return lower(i) + (1ull << (e - SUB_BITS)) - 1;
+}
+
+void LogHistogram::merge_into(summary& s) const{
+    uint64_t n = _count.load(memory_order_acquire);
+    if (n == 0){
+        return;
+    }
+    s.count += n;
+    s.sum   += _sum.load(memory_order_relaxed);
+    s.min    = min(s.min, _min.load(memory_order_relaxed));
+    s.max    = max(s.max, _max.load(memory_order_relaxed));
+    for (unsigned i = 0; i < BUCKETS; ++i){
+        s.buckets[i] += _buckets[i].load(memory_order_relaxed);
+    }
+}
+
+uint64_t LogHistogram::summary::percentile(double q) const{
+    uint64_t total = 0;
+    for (uint64_t b : buckets){
+        total += b;                                                                 ///> may differ from count while threads record
+    }
+    if (total == 0){
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(total) + 0.5));
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < BUCKETS; ++i){
+        seen += buckets[i];
+        if (seen >= rank){
+            uint64_t mid = lower(i) + (upper(i) - lower(i)) / 2;
+            return std::min(std::max(mid, min), max);
+        }
+    }
+    return max;
+}
+
+LogTimer::registry& LogTimer::reg(){
+    static registry& r = *new registry;                                             ///> handles outlive every thread
+    return r;
+}
+
+LogTimer& LogTimer::get(const string& n){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    auto it = r.by_name.find(n);
+    if (it != r.by_name.end()){
+        return *it->second;
+    }
+    LogTimer* t = new LogTimer(n, r.by_name.size());
+    r.by_name.emplace(n, t);
+    return *t;
+}
+
+vector<LogTimer*> LogTimer::all(){
+    registry& r = reg();
+    vector<LogTimer*> v;
+    {
+        lock_guard<mutex> lock(r.mtx);
+        for (auto& it : r.by_name){
+            v.push_back(it.second);
+        }
+    }
+    sort(v.begin(), v.end(), [](const LogTimer* a, const LogTimer* b){ return a->_name < b->_name; });
+    return v;
+}
+
+LogHistogram& LogTimer::local(){
+    struct cache{
+        vector<pair<LogTimer*, LogHistogram*>> hist;                                ///> by timer id
+        ~cache(){
+            for (auto& p : hist){
+                if (p.first){
+                    p.first->release(p.second);                                     ///> timers are never destroyed
+                }
+            }
+        }
+    };
+    static thread_local cache tl;
+    if (_id < tl.hist.size() && tl.hist[_id].second){
+        return *tl.hist[_id].second;
+    }
+    LogHistogram* h = nullptr;
+    {
+        lock_guard<mutex> lock(_mutex);
+        if (!_free.empty()){
+            h = _free.back();                                                       ///> counts stay: they are merged anyway
+            _free.pop_back();
+        }
+        else{
+            h = new LogHistogram();
+            _hist.emplace_back(h);
+        }
+    }
+    if (tl.hist.size() <= _id){
+        tl.hist.resize(_id + 1, {nullptr, nullptr});
+    }
+    tl.hist[_id] = {this, h};
+    return *h;
+}
+
+void LogTimer::release(LogHistogram* h){
+    lock_guard<mutex> lock(_mutex);
+    _free.push_back(h);
+}
+
+LogHistogram::summary LogTimer::collect() const{
+    LogHistogram::summary s;
+    lock_guard<mutex> lock(_mutex);
+    for (const unique_ptr<LogHistogram>& h : _hist){
+        h->merge_into(s);
+    }
+    return s;
+}
+
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <LogTrace.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogHistogram                                                                                                    //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Log-linear latency histogram (HDR style): 16 linear sub-buckets per power of two, <= 6.25% bucket width
+*   - written by one thread only (plain load + store on relaxed atomics, no RMW), readable from any thread
+*   - values are nanoseconds, clamped below 2^40 (~18 min)
+*/
+class LogHistogram{
+public:
+    static constexpr unsigned SUB_BITS  = 4;
+    static constexpr unsigned SUB       = 1u << SUB_BITS;
+    static constexpr unsigned MAX_EXP   = 40;
+    static constexpr unsigned BUCKETS   = (MAX_EXP - SUB_BITS + 1) * SUB;
+
+    /*
+    *   Merged copy of one or more histograms
+    */
+    struct summary{
+        uint64_t                    count       {0};
+        uint64_t                    sum         {0};
+        uint64_t                    min         {UINT64_MAX};
+        uint64_t                    max         {0};
+        std::array<uint64_t, BUCKETS> buckets   {};
+
+        inline double   mean                    () const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+        uint64_t        percentile              (double) const;                     ///> 0.0 .. 1.0, bucket midpoint
+    };
+
+    inline void         record                  (uint64_t);                         ///> Owner thread only
+    void                merge_into              (summary&) const;
+
+    static inline unsigned index                (uint64_t);
+    static uint64_t     lower                   (unsigned);                         ///> Smallest value of a bucket
+    static uint64_t     upper                   (unsigned);                         ///> Largest value of a bucket
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> _buckets {};
+    std::atomic<uint64_t> _count                {0};
+    std::atomic<uint64_t> _sum                  {0};
+    std::atomic<uint64_t> _min                  {UINT64_MAX};
+    std::atomic<uint64_t> _max                  {0};
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogTimer                                                                                                        //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Named latency statistic: one histogram per thread, merged on report
+*   - the histogram of an exited thread keeps its counts and is taken over by the next new thread (one writer)
+*   - get() returns the process-wide handle of a name (keep it in a static, see LOG_TIMER_SCOPE)
+*   - while LogTrace is enabled, every timed scope is also exported as a span of the same name
+*/
+class LogTimer{
+public:
+    static LogTimer&    get                     (const std::string&);               ///> Handle of a name (created on first use, never destroyed)
+    static std::vector<LogTimer*> all           ();                                 ///> Every handle, sorted by name
+
+    LogHistogram&       local                   ();                                 ///> Histogram of the calling thread
+    LogHistogram::summary collect               () const;                           ///> Merge all threads
+    inline const std::string& name              () const { return _name; }
+    inline uint32_t     trace_id                () const { return _trace; }
+
+private:
+    struct registry;
+
+    inline explicit     LogTimer                (const std::string& n, size_t id) : _name(n), _id(id), _trace(LogTrace::intern(n)) {}
+    static registry&    reg                     ();
+    void                release                 (LogHistogram*);                    ///> Calling thread exits: histogram free for reuse
+
+    std::string         _name;
+    size_t              _id;                                                        ///> slot in the per-thread table
+    uint32_t            _trace;                                                     ///> LogTrace name id
+    mutable std::mutex  _mutex;                                                     ///> histogram list
+    std::vector<std::unique_ptr<LogHistogram>> _hist;
+    std::vector<LogHistogram*> _free;                                               ///> of exited threads
+};
+
+/*
+*   RAII timer: records its lifetime into the calling thread's histogram of a LogTimer
+*/
+class ScopedTimer{
+public:
+    inline explicit     ScopedTimer             (LogTimer& t) : _h(t.local()), _trace(t.trace_id()), _start(LogClock::now()) {}
+    inline explicit     ScopedTimer             (const std::string& n) : ScopedTimer(LogTimer::get(n)) {} ///> Name lookup per call
+    inline              ScopedTimer             (const ScopedTimer&)        = delete;
+    inline              ScopedTimer& operator=  (const ScopedTimer&)        = delete;
+    inline              ~ScopedTimer            () {
+        uint64_t d = LogClock::elapsed(_start, LogClock::now());
+        _h.record(d);
+        LogTrace::complete(_trace, _start, d);
+    }
+
+private:
+    LogHistogram&       _h;
+    uint32_t            _trace;
+    uint64_t            _start;
+};
+
+/*
+*   Append a duration with a readable unit: 950ns, 12.3us, 4.56ms, 1.2s
+*/
+void log_append_ns(std::string&, double);
+
+/*
+*   Time the rest of the enclosing scope under a name, with a static handle per statement
+*/
+#define LOG_TIMER_SCOPE(N)  static cpp_up::LogTimer& LOG_CONCAT(_log_timer_, __LINE__) = cpp_up::LogTimer::get((N)); \
+                            cpp_up::ScopedTimer LOG_CONCAT(_log_scope_, __LINE__) (LOG_CONCAT(_log_timer_, __LINE__))
+
+
+
+unsigned LogHistogram::index(uint64_t v){
+    if (v < SUB){
+        return static_cast<unsigned>(v);
+    }
+    unsigned e = 63u - static_cast<unsigned>(__builtin_clzll(v));
+    if (e >= MAX_EXP){
+        return BUCKETS - 1;
+    }
+    return (e - SUB_BITS + 1) * SUB + static_cast<unsigned>((v >> (e - SUB_BITS)) & (SUB - 1));
+}
+
+void LogHistogram::record(uint64_t v){
+    std::atomic<uint64_t>& b = _buckets[index(v)];
+    b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _sum.store(_sum.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    if (v < _min.load(std::memory_order_relaxed)) _min.store(v, std::memory_order_relaxed);
+    if (v > _max.load(std::memory_order_relaxed)) _max.store(v, std::memory_order_relaxed);
+    _count.store(_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogQueue                                                                                                        //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Bounded lock-free multi-producer queue (sequence-numbered ring, D. Vyukov)
+*   - each cell carries a sequence number telling whether it is free for the producer or ready for the consumer
+*   - push/pop SWAP the payload instead of copying it: the caller gets the cell's old (cleared) buffer back,
+*     so string capacity keeps circulating between producers and the writer without heap allocations
+*   - safe for many producers and many consumers (DROP_OLDEST pops from the producer side)
+*/
+template <typename T>
+class LogQueue{
+public:
+    /*
+    *   Construct
+    */
+    inline explicit     LogQueue                (size_t);                           ///> Capacity is rounded up to a power of 2
+    inline              LogQueue                (LogQueue& _src)        = delete;   ///> Copy semantics
+    inline              LogQueue& operator=     (LogQueue const&)       = delete;
+
+    /*
+    *   SYSTEM CONTROL
+    */
+    inline bool         try_push                (T&);                               ///> Swap value into the queue, false if full
+    inline bool         try_pop                 (T&);                               ///> Swap value out of the queue, false if empty
+    inline size_t       capacity                () const { return _mask + 1; }      ///> Number of cells
+
+private:
+    struct alignas(64) cell{
+        std::atomic<size_t> seq;
+        T               data;
+    };
+
+    std::unique_ptr<cell[]> _buf;
+    size_t              _mask;
+    alignas(64) std::atomic<size_t> _enq        {0};
+    alignas(64) std::atomic<size_t> _deq        {0};
+};
+
+
+
+template <typename T>
+LogQueue<T>::LogQueue(size_t _cap){
+    size_t cap = 2;
+    while (cap < _cap){
+        cap <<= 1;
+    }
+    _buf.reset(new cell[cap]);
+    _mask = cap - 1;
+    for (size_t i = 0; i < cap; ++i){
+        _buf[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool LogQueue<T>::try_push(T& _v){
+    size_t pos = _enq.load(std::memory_order_relaxed);
+    for (;;){
+        cell& c = _buf[pos & _mask];
+        size_t seq = c.seq.load(std::memory_order_acquire);
+        intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (dif == 0){
+            if (_enq.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                std::swap(c.data, _v);
+                c.seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (dif < 0){
+            return false;                                                           ///> full
+        }
+        else{
+            pos = _enq.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+bool LogQueue<T>::try_pop(T& _v){
+    size_t pos = _deq.load(std::memory_order_relaxed);
+    for (;;){
+        cell& c = _buf[pos & _mask];
+        size_t seq = c.seq.load(std::memory_order_acquire);
+        intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (dif == 0){
+            if (_deq.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                std::swap(_v, c.data);
+                c.seq.store(pos + _mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (dif < 0){
+            return false;                                                           ///> empty
+        }
+        else{
+            pos = _deq.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <LogFormat.hpp>
+#include <LogLayout.hpp>
+#include <LogProfile.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogRepeat                                                                                                       //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Coalescing state of one thread: its last written line (level, hash & copy of body and log_kv fields, thread)
+*   - a line equal to it within the window (counted from the written copy) is only counted
+*   - the count is written later as one summary record: "last message repeated N times in 1.2ms: <body>"
+*   - mtx: taken by the owning thread per line, by Logger::flush() and by the sweep thread for pending summaries
+*/
+class LogRepeat{
+public:
+    inline bool         repeat                  (const LogRecord&, uint64_t, int64_t); ///> Same as the last line (hash(rec)) within window ns: counted (true)
+    inline void         remember                (const LogRecord&, uint64_t);       ///> rec (hash(rec)) becomes the last written line
+    inline bool         take                    (std::string&, LogRecord&);         ///> Pending count as summary record (text in string), resets it
+    inline bool         expired                 (std::chrono::system_clock::time_point, int64_t) const; ///> Pending count whose window (ns) ended before now
+    static inline uint64_t hash                 (std::string_view);
+    static inline uint64_t hash                 (const LogRecord& r) { return r.fields.empty() ? hash(r.body) : hash(r.body) ^ hash(r.fields) * 31; }
+
+    std::mutex          mtx;
+
+private:
+    static constexpr size_t QUOTE               = 80;                               ///> body bytes repeated in a summary
+
+    uint64_t            _hash                   {0};
+    std::string         _body;                                                      ///> confirms a hash match
+    std::string         _fields;
+    unsigned            _level                  {0};
+    const char*         _file                   {nullptr};
+    unsigned            _line                   {0};
+    uint64_t            _thread                 {0};
+    std::chrono::system_clock::time_point _first;                                   ///> written copy
+    std::chrono::system_clock::time_point _last;                                    ///> latest counted repeat
+    uint64_t            _count                  {0};
+    bool                _valid                  {false};
+};
+
+
+
+uint64_t LogRepeat::hash(std::string_view s){
+    const uint64_t mul = 0x9E3779B97F4A7C15ull;
+    uint64_t h = s.size() * mul;
+    size_t i = 0;
+    for (; i + 8 <= s.size(); i += 8){
+        uint64_t v;
+        memcpy(&v, s.data() + i, 8);
+        h = (h ^ v) * mul;
+        h ^= h >> 29;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, s.data() + i, s.size() - i);
+    h = (h ^ tail) * mul;
+    return h ^ h >> 32;
+}
+
+bool LogRepeat::repeat(const LogRecord& rec, uint64_t h, int64_t window){
+    if (!_valid || h != _hash || rec.level != _level || (rec.thread != 0 && rec.thread != _thread)){
+        return false;
+    }
+    if (rec.time - _first > std::chrono::nanoseconds(window) || rec.body != _body || rec.fields != _fields){
+        return false;
+    }
+    _last = rec.time;
+    ++_count;
+    return true;
+}
+
+void LogRepeat::remember(const LogRecord& rec, uint64_t h){
+    _hash   = h;
+    _body.assign(rec.body.data(), rec.body.size());
+    _fields.assign(rec.fields.data(), rec.fields.size());
+    _level  = rec.level;
+    _file   = rec.file;
+    _line   = rec.line;
+    _thread = rec.thread ? rec.thread : log_thread_id();                            ///> summaries may be written by flush()
+    _first  = _last = rec.time;
+    _count  = 0;
+    _valid  = true;
+}
+
+bool LogRepeat::expired(std::chrono::system_clock::time_point now, int64_t window) const{
+    return _count != 0 && now - _first > std::chrono::nanoseconds(window);
+}
+
+bool LogRepeat::take(std::string& text, LogRecord& rec){
+    if (_count == 0){
+        return false;
+    }
+    text.assign("last message repeated ");
+    log_append(text, _count);
+    text.append(_count == 1 ? " time in " : " times in ");
+    log_append_ns(text, static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(_last - _first).count()));
+    text.append(": ").append(_body, 0, QUOTE);                                     ///> threads interleave: name the line
+    if (_body.size() > QUOTE){
+        text.append("...");
+    }
+    rec    = {_level, _last, _file, _line, text, _thread, _fields};
+    _count = 0;
+    return true;
+}
+
+}
@@ -0,0 +1,257 @@
+#include <LogShm.hpp>
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace cpp_up{
+
+static_assert(sizeof(ShmSink::header) <= ShmSink::DATA, "ShmSink header overlaps the ring");
+static_assert(sizeof(ShmSink::record) == 24, "ShmSink record layout changed");
+
+/*
+*   Position after a record of `size` bytes; a rest too short for a record header is skipped (both sides agree)
+*/
+static uint64_t shm_advance(uint64_t pos, uint64_t size, uint64_t cap){
+    pos += size;
+    uint64_t left = cap - (pos & (cap - 1));
+    return left < sizeof(ShmSink::record) ? pos + left : pos;
+}
+
+static uint64_t shm_size(uint64_t len){
+    return (sizeof(ShmSink::record) + len + 7) & ~uint64_t(7);
+}
+
+string ShmSink::shm_name(const string& _name){
+    return _name.empty() || _name[0] != '/' ? "/cpp_up." + _name : _name;
+}
+
+bool ShmSink::remove(const string& _name){
+    return shm_unlink(shm_name(_name).c_str()) == 0;
+}
+
+ShmSink::ShmSink(const string& _name, size_t _capacity){
+    string n = shm_name(_name);
+    _cap = 4096;
+    while (_cap < _capacity){
+        _cap <<= 1;
+    }
+    _size = DATA + _cap;
+
+    int fd = shm_open(n.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0){
+        return;
+    }
+    struct stat st;
+    bool reuse = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == _size;
+    if (!reuse && st.st_size != 0){
+        ///> other capacity: a fresh segment, readers of the old one see replaced()
+        ::close(fd);
+        shm_unlink(n.c_str());
+        fd = shm_open(n.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0){
+            return;
+        }
+    }
+    if (!reuse && ftruncate(fd, static_cast<off_t>(_size)) != 0){
+        ::close(fd);
+        return;
+    }
+    void* p = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED){
+        return;
+    }
+    _hdr  = static_cast<header*>(p);
+    _data = static_cast<char*>(p) + DATA;
+
+    ///> continue a ring left by an earlier producer: positions & line numbers go on
+    uint64_t head = _hdr->head.load(memory_order_acquire);
+    uint64_t tail = _hdr->tail.load(memory_order_acquire);
+    if (reuse && _hdr->magic == MAGIC && _hdr->capacity == _cap && tail <= head && head - tail <= _cap){
+        _head = head;
+        _tail = tail;
+        _seq  = _hdr->seq.load(memory_order_relaxed);
+    }
+    else{
+        _hdr->capacity = _cap;
+        _hdr->head.store(0, memory_order_relaxed);
+        _hdr->tail.store(0, memory_order_relaxed);
+        _hdr->seq.store(0, memory_order_relaxed);
+        _hdr->magic = MAGIC;
+    }
+    _hdr->pid = static_cast<uint32_t>(getpid());
+}
+
+ShmSink::~ShmSink(){
+    if (_hdr){
+        munmap(_hdr, _size);
+    }
+}
+
+void ShmSink::reclaim(uint64_t _end){
+    if (_end - _tail <= _cap){
+        return;
+    }
+    while (_end - _tail > _cap - _cap / 8){                                         ///> in steps: fewer tail stores for readers to miss on
+        const record* r = reinterpret_cast<const record*>(_data + (_tail & (_cap - 1)));
+        _tail = shm_advance(_tail, shm_size(r->len), _cap);
+    }
+    ///> seqlock: readers that copied any byte written after this fence see the new tail
+    _hdr->tail.store(_tail, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+void ShmSink::put(const char* p, size_t n, unsigned level, uint8_t flags){
+    uint64_t size = shm_size(n);
+    reclaim(_head + size);
+    record* r = reinterpret_cast<record*>(_data + (_head & (_cap - 1)));
+    r->pos   = _head;
+    r->seq   = flags & FLAG_PAD ? _seq + 1 : ++_seq;                                ///> pad: number of the line after it
+    r->len   = static_cast<uint32_t>(n);
+    r->level = static_cast<uint8_t>(level);
+    r->flags = flags;
+    if (p){
+        memcpy(r + 1, p, n);
+    }
+    if (flags & FLAG_CUT){
+        reinterpret_cast<char*>(r + 1)[n - 1] = '\n';
+    }
+    _head = shm_advance(_head, size, _cap);
+    _hdr->seq.store(_seq, memory_order_relaxed);
+    _hdr->head.store(_head, memory_order_release);
+}
+
+void ShmSink::write(const char* p, size_t n, unsigned level){
+    if (!_hdr || n == 0){
+        return;
+    }
+    bool cut = n > _cap / 4;                                                        ///> longer lines are cut, keeping the '\n'
+    if (cut){
+        n = _cap / 4;
+    }
+    uint64_t at = _head & (_cap - 1);
+    if (at + shm_size(n) > _cap){
+        put(nullptr, _cap - at - sizeof(record), 0, FLAG_PAD);                      ///> records never wrap
+    }
+    put(p, n, level, cut ? FLAG_CUT : 0);
+}
+
+ShmReader::ShmReader(const string& _name, bool _from_start)
+    : _name(ShmSink::shm_name(_name))
+{
+    int fd = shm_open(this->_name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0){
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < ShmSink::DATA + 4096){
+        ::close(fd);
+        return;
+    }
+    _size = static_cast<size_t>(st.st_size);
+    _ino  = static_cast<uint64_t>(st.st_ino);
+    void* p = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED){
+        return;
+    }
+    const ShmSink::header* h = static_cast<const ShmSink::header*>(p);
+    uint64_t cap = h->capacity;
+    if (h->magic != ShmSink::MAGIC || cap == 0 || (cap & (cap - 1)) != 0 || ShmSink::DATA + cap != _size){
+        munmap(p, _size);
+        return;
+    }
+    _hdr  = h;
+    _data = static_cast<const char*>(p) + ShmSink::DATA;
+    _mask = cap - 1;
+    _pos  = h->head.load(memory_order_acquire);
+    _head = _pos;
+    _seq  = h->seq.load(memory_order_relaxed);                                      ///> lost() counts from here
+    while (_from_start){
+        ///> oldest line & the number before it, retried while the producer overwrites it
+        uint64_t tail = h->tail.load(memory_order_acquire);
+        ShmSink::record r;
+        memcpy(&r, _data + (tail & _mask), sizeof(r));
+        atomic_thread_fence(memory_order_acquire);
+        if (h->tail.load(memory_order_relaxed) != tail){
+            continue;
+        }
+        if (tail != _pos){
+            _seq = r.pos == tail ? r.seq - 1 : h->seq.load(memory_order_relaxed);
+        }
+        _pos = tail;
+        break;
+    }
+}
+
+ShmReader::~ShmReader(){
+    if (_hdr){
+        munmap(const_cast<ShmSink::header*>(_hdr), _size);
+    }
+}
+
+bool ShmReader::next(string& _line, unsigned& _level){
+    if (!_hdr){
+        return false;
+    }
+    uint64_t cap = _mask + 1;
+    for (;;){
+        if (_pos == _head){
+            _head = _hdr->head.load(memory_order_acquire);                          ///> the producer's hot line: only when caught up
+            if (_pos == _head){
+                return false;
+            }
+        }
+        uint64_t tail = _hdr->tail.load(memory_order_acquire);
+        if (_pos < tail || _pos > _head){
+            _pos  = tail;                                                           ///> overtaken (or ring restarted): oldest intact line
+            _head = _hdr->head.load(memory_order_acquire);
+            continue;
+        }
+        const char* at = _data + (_pos & _mask);
+        ShmSink::record r;
+        memcpy(&r, at, sizeof(r));
+        bool ok = r.pos == _pos && sizeof(r) + r.len <= cap - (_pos & _mask);
+        bool pad = r.flags & ShmSink::FLAG_PAD;
+        if (ok && !pad){
+            _line.assign(at + sizeof(r), r.len);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (_hdr->tail.load(memory_order_relaxed) > _pos){
+            continue;                                                               ///> overwritten while copying
+        }
+        if (!ok){
+            _pos = _head;                                                           ///> damaged ring: skip to the newest line
+            continue;
+        }
+        _pos = shm_advance(_pos, shm_size(r.len), cap);
+        if (pad){
+            continue;
+        }
+        if (r.seq > _seq + 1){
+            _lost += r.seq - _seq - 1;
+        }
+        _seq   = r.seq;
+        _level = r.level;
+        return true;
+    }
+}
+
+bool ShmReader::replaced() const{
+    int fd = shm_open(_name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0){
+        return false;                                                               ///> removed, nothing to attach to yet
+    }
+    struct stat st;
+    bool other = fstat(fd, &st) == 0 && (static_cast<uint64_t>(st.st_ino) != _ino || !_hdr);
+    ::close(fd);
+    return other;
+}
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <LogSink.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ShmSink                                                                                                         //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Lines published into a named POSIX shared-memory ring (live view for cpp_up_tail & ShmReader)
+*   - a line is one memcpy + a release store of the head: no syscall, no lock, nothing waits for readers,
+*     so attached observers cost the producer nothing and a ring nobody reads costs the same
+*   - overwrite-oldest: the tail is moved past the records a new one covers before they are overwritten
+*     (in steps of capacity / 8, on its own cache line); readers validate every copy against the tail (seqlock)
+*     and count what they lost
+*   - one record per line with its own level (the async writer does not batch for this sink)
+*   - the segment outlives the process (the last lines of a crash stay readable); a new producer of the same
+*     name & capacity continues it, attached readers keep following. remove() unlinks it
+*   - one producer per name
+*
+*   segment : header (256 bytes) | data (capacity bytes, power of two)
+*   header  : "CPUPSHM1", uint64 capacity, uint32 pid, at 64: atomic uint64 head (end of the newest record),
+*             atomic uint64 seq (newest line number), at 128: atomic uint64 tail (start of the oldest intact record);
+*             positions count bytes ever written
+*   record  : uint64 position, uint64 sequence, uint32 length, uint8 level, uint8 flags, text, padded to 8 bytes;
+*             never wraps: the rest of the ring is filled with a FLAG_PAD record instead
+*/
+class ShmSink : public LogSink{
+public:
+    static constexpr uint64_t MAGIC             = 0x314d485350555043ull;            ///> "CPUPSHM1"
+
+    struct header{
+        uint64_t                magic;
+        uint64_t                capacity;
+        uint32_t                pid;
+        alignas(64) std::atomic<uint64_t> head;                                     ///> written per line
+        std::atomic<uint64_t>   seq;
+        alignas(64) std::atomic<uint64_t> tail;                                     ///> written per capacity / 8, read per line
+    };
+    struct record{
+        uint64_t        pos;                                                        ///> must match the read position
+        uint64_t        seq;                                                        ///> line number, gaps = lost lines
+        uint32_t        len;
+        uint8_t         level;
+        uint8_t         flags;
+        uint16_t        reserved;
+    };
+    static constexpr uint8_t FLAG_PAD           = 1;                                ///> filler up to the end of the ring
+    static constexpr uint8_t FLAG_CUT           = 2;                                ///> line longer than capacity / 4, cut
+    static constexpr size_t DATA                = 256;                              ///> offset of the ring in the segment
+
+    /*
+    *   Construct
+    */
+                        ShmSink                 (const std::string&, size_t capacity = 4 << 20); ///> Name ("app" -> "/cpp_up.app")
+    inline              ShmSink                 (ShmSink& _src)         = delete;   ///> Copy semantics
+    inline              ShmSink& operator=      (ShmSink const&)        = delete;
+                        ~ShmSink                () override;                        ///> Unmap, the segment stays
+
+    /*
+    *   SYSTEM CONTROL
+    */
+    void                write                   (const char*, size_t, unsigned) override;
+    inline bool         batched                 () const override { return false; }
+    inline bool         is_open                 () const { return _hdr != nullptr; }
+    static bool         remove                  (const std::string&);               ///> Unlink a segment
+    static std::string  shm_name                (const std::string&);               ///> "app" -> "/cpp_up.app"
+
+private:
+    void                put                     (const char*, size_t, unsigned, uint8_t);
+    void                reclaim                 (uint64_t);                         ///> Move the tail so [.., end) may be overwritten
+
+    header*             _hdr                    {nullptr};
+    char*               _data                   {nullptr};
+    uint64_t            _cap                    {0};
+    uint64_t            _head                   {0};                                ///> producer copies of the shared positions
+    uint64_t            _tail                   {0};
+    uint64_t            _seq                    {0};
+    size_t              _size                   {0};                                ///> mapped bytes
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ShmReader                                                                                                       //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Read-only view of a ShmSink ring from any process (never writes to the segment, never slows the producer)
+*   - next() returns false when nothing new is published (poll it, see cpp_up_tail)
+*   - a reader overtaken by the producer jumps to the oldest intact line; lost() counts the skipped lines
+*/
+class ShmReader{
+public:
+    /*
+    *   Construct
+    */
+    explicit            ShmReader               (const std::string&, bool from_start = true); ///> Name as for ShmSink; false = new lines only
+    inline              ShmReader               (ShmReader& _src)       = delete;   ///> Copy semantics
+    inline              ShmReader& operator=    (ShmReader const&)      = delete;
+                        ~ShmReader              ();
+
+    /*
+    *   SYSTEM CONTROL
+    */
+    bool                next                    (std::string&, unsigned&);          ///> Copy the next line (with '\n') & its level
+    bool                replaced                () const;                           ///> Name now refers to another segment (reattach)
+    inline bool         is_open                 () const { return _hdr != nullptr; }
+    inline uint64_t     lost                    () const { return _lost; }
+    inline uint32_t     pid                     () const { return _hdr ? _hdr->pid : 0; }
+
+private:
+    const ShmSink::header* _hdr                 {nullptr};
+    const char*         _data                   {nullptr};
+    std::string         _name;
+    uint64_t            _mask                   {0};
+    uint64_t            _pos                    {0};
+    uint64_t            _head                   {0};                                ///> last head seen, reloaded once reached
+    uint64_t            _seq                    {0};                                ///> number of the last line read
+    uint64_t            _lost                   {0};
+    uint64_t            _ino                    {0};
+    size_t              _size                   {0};
+};
+
+}
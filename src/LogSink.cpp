@@ -0,0 +1,57 @@
+#include <LogSink.hpp>
+
+#include <cstring>
+#include <ostream>
+
+#include <LogTty.hpp>
+
+using namespace std;
+
+namespace cpp_up{
+
+void OstreamSink::write(const char* p, size_t n, unsigned){
+    _fac.write(p, static_cast<streamsize>(n));
+}
+
+void OstreamSink::flush(){
+    _fac.flush();
+}
+
+bool OstreamSink::is_tty() const{
+    return LogTty::is_tty(_fac);
+}
+
+void MemorySink::write(const char* p, size_t n, unsigned){
+    lock_guard<mutex> lock(_mutex);
+    const char* end = p + n;
+    while (p < end){
+        const char* nl = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* e  = nl ? nl : end;
+        if (_lines.size() == _max){
+            if (_max == 0){
+                return;
+            }
+            _lines[_first].assign(p, e);                                            ///> reuse the oldest buffer
+            _first = (_first + 1) % _max;
+        }
+        else{
+            _lines.emplace_back(p, e);
+        }
+        p = nl ? nl + 1 : end;
+    }
+}
+
+vector<string> MemorySink::lines() const{
+    lock_guard<mutex> lock(_mutex);
+    vector<string> v(_lines.begin() + static_cast<long>(_first), _lines.end());
+    v.insert(v.end(), _lines.begin(), _lines.begin() + static_cast<long>(_first));
+    return v;
+}
+
+void MemorySink::clear(){
+    lock_guard<mutex> lock(_mutex);
+    _lines.clear();
+    _first = 0;
+}
+
+}
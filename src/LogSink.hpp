@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cpp_up{
+
+class Logger;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogSink                                                                                                         //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Output target of the Logger
+*   - write() gets one or more finished lines ('\n' terminated) and the most severe level among them
+*     (exactly one line if batched() is false)
+*   - calls are serialized by the Logger, a sink does not need its own lock against other writers
+*     (a sink added to several Loggers is locked by them once the second one adds it)
+*   - emergency_flush() & emergency_write() run inside a crash handler: write(2) only, no blocking lock, no allocation
+*/
+class LogSink{
+public:
+    virtual             ~LogSink                () = default;
+    virtual void        write                   (const char*, size_t, unsigned) = 0;///> Append finished line(s)
+    virtual void        flush                   () {}                               ///> Push buffered data to the device
+    virtual void        emergency_flush         () {}                               ///> Best-effort flush from a signal handler
+    virtual bool        emergency_write         (const char*, size_t) { return false; } ///> One line from a signal handler, false = no raw path (stderr gets it)
+    virtual bool        is_tty                  () const { return false; }          ///> Terminal: gets colors (Logger::set_sink_tty overrides)
+    virtual bool        batched                 () const { return true; }           ///> Async writer may join lines into one write()
+
+private:
+    friend class Logger;
+    std::atomic<bool>   _shared                 {false};                            ///> attached to several Loggers: calls hold _share_mutex
+    std::mutex          _share_mutex;
+    Logger*             _owner                  {nullptr};                          ///> first Logger, write barrier when another one joins
+};
+
+/*
+*   Sink over an existing ostream (cout/cerr/clog/ofstream/...)
+*   - no crash path: what the stream buffers is lost on a crash, queued async lines go to stderr instead
+*/
+class OstreamSink : public LogSink{
+public:
+    inline explicit     OstreamSink             (std::ostream& f) : _fac(f) {}
+
+    void                write                   (const char*, size_t, unsigned) override;
+    void                flush                   () override;
+    bool                is_tty                  () const override;
+    inline std::ostream& stream                 () { return _fac; }
+
+private:
+    std::ostream&       _fac;
+};
+
+/*
+*   Sink keeping the last N lines in memory (tests, crash reports, UI consoles)
+*/
+class MemorySink : public LogSink{
+public:
+    inline explicit     MemorySink              (size_t max_lines = 1024) : _max(max_lines) {}
+
+    void                write                   (const char*, size_t, unsigned) override;
+    std::vector<std::string> lines              () const;                           ///> Copy of the kept lines (without '\n')
+    void                clear                   ();
+
+private:
+    mutable std::mutex  _mutex;                                                     ///> readers are not serialized by the Logger
+    std::vector<std::string> _lines;                                                ///> ring once full, oldest at _first
+    size_t              _first                  {0};
+    size_t              _max;
+};
+
+}
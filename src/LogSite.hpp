@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <LogFormat.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogSite                                                                                                         //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Text of a char array argument, registered once (never freed)
+*/
+struct LogLiteral{
+    uint32_t            id;
+    std::string         text;
+};
+
+/*
+*   Static state of one LOG_MSG statement (one instance per call site, constant-initialized)
+*/
+struct LogSite{
+    const char*                 file;
+    unsigned                    line;
+    std::atomic<uint32_t>       bin_id          {0};                                ///> binary descriptor id, 0 = not registered yet
+    std::array<std::atomic<const LogLiteral*>, 8> bin_lit {};                       ///> binary literal cache per argument (checked by content)
+    std::atomic<uint64_t>       hits            {0};                                ///> limiter: calls seen (every N / first N)
+    std::atomic<int64_t>        tat             {0};                                ///> limiter: token bucket theoretical arrival time (ns)
+    std::atomic<uint64_t>       skipped         {0};                                ///> limiter: suppressed since the last emitted line
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogBinaryRecord                                                                                                 //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Open record of a statement in binary mode: the part of a LogBinary thread buffer its << operands fill inline
+*   - begin() & end() live in LogBinary.cpp, the argument encoding stays here (no call per argument)
+*   record  : varint id << 3 | level, zigzag varint time delta (ns), arguments, TAG_END
+*/
+struct LogBinaryRecord{
+    enum tag : uint8_t{
+        TAG_END                 = 0,
+        TAG_INT                 = 1,                                                ///> zigzag varint
+        TAG_UINT                = 2,                                                ///> varint
+        TAG_DOUBLE              = 3,                                                ///> 8 bytes
+        TAG_FALSE               = 4,
+        TAG_TRUE                = 5,
+        TAG_CHAR                = 6,                                                ///> 1 byte
+        TAG_STRING              = 7,                                                ///> varint length, bytes
+        TAG_LITERAL             = 8                                                 ///> varint literal id
+    };
+
+    LogSite*            site                    {nullptr};                          ///> site of the open record
+    unsigned            arg                     {0};                                ///> index of the next argument
+    unsigned            depth                   {0};                                ///> outer records of nested statements
+    std::string         data                    {};
+
+    template <class T>
+    inline void         append                  (const T&);                         ///> Add argument value
+    inline void         append_literal          (const char*, size_t);              ///> Add char array text (stored once while it stays the same)
+    void                end                     ();                                 ///> Close record
+
+    static inline void  put_varint              (std::string&, uint64_t);
+    static inline void  put_string              (std::string&, std::string_view);
+    static inline uint64_t zigzag               (int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+
+private:
+    static std::string& scratch                 ();
+    static const LogLiteral* register_literal   (std::atomic<const LogLiteral*>&, std::string_view);
+};
+
+
+
+void LogBinaryRecord::put_varint(std::string& d, uint64_t v){
+    char buf[10];
+    size_t n = 0;
+    while (v >= 0x80){
+        buf[n++] = static_cast<char>(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = static_cast<char>(v);
+    d.append(buf, n);
+}
+
+void LogBinaryRecord::put_string(std::string& d, std::string_view s){
+    d.push_back(static_cast<char>(TAG_STRING));
+    put_varint(d, s.size());
+    d.append(s.data(), s.size());
+}
+
+template <class T>
+void LogBinaryRecord::append(const T& v){
+    std::string& d = data;
+    if constexpr (std::is_same_v<T, bool>){
+        d.push_back(static_cast<char>(v ? TAG_TRUE : TAG_FALSE));
+    }
+    else if constexpr (std::is_same_v<T, char>){                                     ///> int8_t/uint8_t: integers, as in log_append
+        d.push_back(static_cast<char>(TAG_CHAR));
+        d.push_back(v);
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>){
+        d.push_back(static_cast<char>(TAG_INT));
+        put_varint(d, zigzag(static_cast<int64_t>(v)));
+    }
+    else if constexpr (std::is_integral_v<T>){
+        d.push_back(static_cast<char>(TAG_UINT));
+        put_varint(d, static_cast<uint64_t>(v));
+    }
+    else if constexpr (std::is_floating_point_v<T>){
+        double x = static_cast<double>(v);                                          ///> same 6 significant digits once decoded
+        d.push_back(static_cast<char>(TAG_DOUBLE));
+        d.append(reinterpret_cast<const char*>(&x), sizeof(x));
+    }
+    else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>){
+        put_string(d, v ? std::string_view(v) : std::string_view());
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>){
+        put_string(d, std::string_view(v));
+    }
+    else{
+        std::string nested;
+        std::string& s = depth == 0 ? scratch() : nested;                           ///> user types are formatted right away
+        s.clear();
+        log_append(s, v);
+        put_string(d, s);
+    }
+    ++arg;
+}
+
+void LogBinaryRecord::append_literal(const char* s, size_t cap){
+    std::string_view text(s, strnlen(s, cap));
+    if (site->file && arg < site->bin_lit.size()){
+        std::atomic<const LogLiteral*>& slot = site->bin_lit[arg];
+        const LogLiteral* l = slot.load(std::memory_order_acquire);
+        if (!l || l->text != text){
+            l = register_literal(slot, text);                                        ///> array content changed (not a literal)
+        }
+        if (l){
+            data.push_back(static_cast<char>(TAG_LITERAL));
+            put_varint(data, l->id);
+            ++arg;
+            return;
+        }
+    }
+    append(text);
+}
+
+}
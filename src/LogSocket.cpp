@@ -0,0 +1,403 @@
+#include <LogSocket.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace chrono;
+
+namespace cpp_up{
+
+/*
+*   Parsed & resolved "unix:", "unixgram:", "tcp:" or "udp:" address
+*/
+struct sock_addr{
+    int                 family;
+    int                 type;
+    sockaddr_storage    addr;
+    socklen_t           len;
+};
+
+/*
+*   passive: resolve for bind() (listeners), else for connect()
+*/
+static bool sock_parse(const string& a, sock_addr& out, bool passive){
+    memset(&out, 0, sizeof(out));
+    size_t colon = a.find(':');
+    if (colon == string::npos){
+        return false;
+    }
+    string kind = a.substr(0, colon), rest = a.substr(colon + 1);
+    if (kind == "unix" || kind == "unixgram"){
+        sockaddr_un un {};
+        if (rest.empty() || rest.size() >= sizeof(un.sun_path)){
+            return false;
+        }
+        un.sun_family = AF_UNIX;
+        memcpy(un.sun_path, rest.data(), rest.size());
+        memcpy(&out.addr, &un, sizeof(un));
+        out.family = AF_UNIX;
+        out.type   = kind == "unix" ? SOCK_STREAM : SOCK_DGRAM;
+        out.len    = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + rest.size() + 1);
+        return true;
+    }
+    if (kind != "tcp" && kind != "udp"){
+        return false;
+    }
+    size_t port = rest.rfind(':');
+    if (port == string::npos){
+        return false;
+    }
+    string host = rest.substr(0, port);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']'){
+        host = host.substr(1, host.size() - 2);                                    ///> [::1]:5140
+    }
+    addrinfo hints {};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = kind == "tcp" ? SOCK_STREAM : SOCK_DGRAM;
+    hints.ai_flags    = passive ? AI_PASSIVE : 0;                                   ///> listener: no host = any address, sender: loopback
+    addrinfo* res = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), rest.c_str() + port + 1, &hints, &res) != 0 || !res){
+        return false;
+    }
+    memcpy(&out.addr, res->ai_addr, res->ai_addrlen);
+    out.family = res->ai_family;
+    out.type   = res->ai_socktype;
+    out.len    = res->ai_addrlen;
+    freeaddrinfo(res);
+    return true;
+}
+
+/*
+*   Bytes of the frame starting at p (length prefix included)
+*/
+static size_t frame_size(const char* p){
+    const unsigned char* h = reinterpret_cast<const unsigned char*>(p);
+    return 4 + (h[0] | h[1] << 8 | h[2] << 16 | static_cast<size_t>(h[3]) << 24);
+}
+
+bool SocketSink::is_stream(const string& _a){
+    return _a.compare(0, 5, "unix:") == 0 || _a.compare(0, 4, "tcp:") == 0;
+}
+
+int SocketSink::listen_socket(const string& _a){
+    sock_addr sa;
+    if (!sock_parse(_a, sa, true)){
+        return -1;
+    }
+    int fd = socket(sa.family, sa.type | SOCK_CLOEXEC, 0);
+    if (fd < 0){
+        return -1;
+    }
+    if (sa.family == AF_UNIX){
+        unlink(reinterpret_cast<sockaddr_un*>(&sa.addr)->sun_path);                ///> stale socket file of an earlier receiver
+    }
+    else{
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    }
+    if (sa.type == SOCK_DGRAM){
+        int size = 4 << 20;                                                         ///> udp has no back pressure: room for bursts
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&sa.addr), sa.len) != 0 || (sa.type == SOCK_STREAM && listen(fd, 64) != 0)){
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+SocketSink::SocketSink(const string& _a)
+    : SocketSink(_a, config())
+{
+}
+
+SocketSink::SocketSink(const string& _a, const config& _c)
+    : _address(_a), _cfg(_c), _stream(is_stream(_a))
+{
+    if (_cfg.max_datagram == 0){
+        _cfg.max_datagram = _address.compare(0, 4, "udp:") == 0 ? 1472 : 16 << 10;
+    }
+    _max_line = _stream ? UINT32_MAX : _cfg.max_datagram - 4;
+    _front.reserve(_cfg.batch_bytes + (_cfg.batch_bytes >> 2));
+    _back.reserve(_front.capacity());
+    _io = thread(&SocketSink::io_loop, this);
+}
+
+SocketSink::~SocketSink(){
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+    }
+    _io_cv.notify_one();
+    if (_io.joinable()){
+        _io.join();
+    }
+    disconnect();
+}
+
+void SocketSink::write(const char* p, size_t n, unsigned level){
+    if (n > 0 && p[n - 1] == '\n'){
+        --n;
+    }
+    n = min(n, _max_line);
+    unique_lock<mutex> lock(_mutex);
+    if (_front.size() + _backlog + 4 + n > _cfg.max_pending){
+        _dropped.fetch_add(1, memory_order_relaxed);                               ///> collector slow or away: never wait
+        return;
+    }
+    uint32_t len = static_cast<uint32_t>(n);
+    char hdr[4] {static_cast<char>(len), static_cast<char>(len >> 8), static_cast<char>(len >> 16), static_cast<char>(len >> 24)};
+    _front.append(hdr, 4);
+    _front.append(p, n);
+    if (_front.size() >= _cfg.batch_bytes || level <= _cfg.flush_level){
+        _kick = true;
+        lock.unlock();
+        _io_cv.notify_one();
+    }
+}
+
+void SocketSink::flush(){
+    unique_lock<mutex> lock(_mutex);
+    uint64_t target = ++_flush_req;
+    _kick = true;
+    _io_cv.notify_one();
+    _done_cv.wait(lock, [this, target]{ return _flush_done >= target || _stop; });
+}
+
+void SocketSink::emergency_flush(){
+    if (_stream || !_mutex.try_lock()){
+        return;                                                                     ///> a stream may hold half a frame of the I/O thread
+    }
+    int fd = _fd.load(memory_order_relaxed);
+    size_t at = 0;
+    while (fd >= 0 && at < _front.size()){
+        size_t end = at;
+        while (end < _front.size()){
+            size_t f = frame_size(_front.data() + end);
+            if (end > at && end + f - at > _cfg.max_datagram){
+                break;
+            }
+            end += f;
+        }
+        if (::send(fd, _front.data() + at, end - at, MSG_DONTWAIT | MSG_NOSIGNAL) < 0){
+            break;
+        }
+        at = end;
+    }
+    _front.erase(0, at);
+    _mutex.unlock();
+}
+
+bool SocketSink::emergency_write(const char* p, size_t n){
+    int fd = _fd.load(memory_order_relaxed);
+    if (_stream || fd < 0){
+        return false;                                                               ///> a stream may hold half a frame of the I/O thread
+    }
+    char frame[4 + 1024];
+    if (n > 0 && p[n - 1] == '\n'){
+        --n;
+    }
+    n = min({n, _max_line, sizeof(frame) - 4});
+    uint32_t len = static_cast<uint32_t>(n);
+    frame[0] = static_cast<char>(len);
+    frame[1] = static_cast<char>(len >> 8);
+    frame[2] = static_cast<char>(len >> 16);
+    frame[3] = static_cast<char>(len >> 24);
+    memcpy(frame + 4, p, n);
+    return ::send(fd, frame, 4 + n, MSG_DONTWAIT | MSG_NOSIGNAL) >= 0;
+}
+
+void SocketSink::io_loop(){
+    unique_lock<mutex> lock(_mutex);
+    steady_clock::time_point linger {};
+    for (;;){
+        if (!_stop){
+            _io_cv.wait_for(lock, _cfg.batch_interval, [this]{ return _kick || _stop; });
+        }
+        _kick = false;
+        bool stop = _stop;
+        uint64_t req = _flush_req;
+        if (_off == _back.size()){
+            _back.clear();
+            _off = _next_frame = 0;
+            swap(_front, _back);
+        }
+        else{
+            _back.append(_front);                                                   ///> behind the unsent rest
+            _front.clear();
+        }
+        lock.unlock();
+
+        if (stop && linger == steady_clock::time_point{}){
+            linger = steady_clock::now() + seconds(1);
+        }
+        if (_off < _back.size() && (_fd.load(memory_order_relaxed) >= 0 || connect_socket())){
+            _stream ? send_stream() : send_datagrams();
+        }
+        if (_next_frame > (_back.size() >> 1)){
+            _back.erase(0, _next_frame);                                            ///> keep the unsent rest at the start
+            _off -= _next_frame;
+            _next_frame = 0;
+        }
+
+        lock.lock();
+        _backlog = _back.size() - _off;
+        _flush_done = req;
+        _done_cv.notify_all();
+        if (stop && ((_backlog == 0 && _front.empty()) || steady_clock::now() >= linger)){
+            uint64_t lost = 0;                                                      ///> what the collector did not take in time
+            for (size_t at = _next_frame; at < _back.size(); at += frame_size(_back.data() + at)){
+                ++lost;
+            }
+            for (size_t at = 0; at < _front.size(); at += frame_size(_front.data() + at)){
+                ++lost;
+            }
+            _dropped.fetch_add(lost, memory_order_relaxed);
+            break;
+        }
+        if (stop){
+            lock.unlock();
+            this_thread::sleep_for(milliseconds(10));
+            lock.lock();
+        }
+    }
+}
+
+bool SocketSink::connect_socket(){
+    steady_clock::time_point now = steady_clock::now();
+    if (now < _retry_at){
+        return false;
+    }
+    _retry_at = now + _cfg.retry_interval;
+    sock_addr sa;
+    if (!sock_parse(_address, sa, false)){
+        return false;
+    }
+    int fd = socket(sa.family, sa.type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0){
+        return false;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&sa.addr), sa.len) != 0){
+        int err = errno;
+        pollfd pfd {fd, POLLOUT, 0};
+        int ready = err == EINPROGRESS ? poll(&pfd, 1, static_cast<int>(_cfg.retry_interval.count())) : -1;
+        socklen_t len = sizeof(err);
+        if (ready <= 0 || getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0){
+            ::close(fd);
+            return false;
+        }
+    }
+    if (_next_frame < _off){
+        _off = _next_frame + frame_size(_back.data() + _next_frame);                ///> line cut by the last connection
+        _next_frame = _off;
+        _dropped.fetch_add(1, memory_order_relaxed);
+    }
+    _fd.store(fd, memory_order_relaxed);
+    return true;
+}
+
+void SocketSink::disconnect(){
+    int fd = _fd.exchange(-1, memory_order_relaxed);
+    if (fd >= 0){
+        ::close(fd);
+    }
+}
+
+bool SocketSink::wait_writable(milliseconds _wait){
+    pollfd pfd {_fd.load(memory_order_relaxed), POLLOUT, 0};
+    return poll(&pfd, 1, static_cast<int>(_wait.count())) > 0 && !(pfd.revents & (POLLERR | POLLHUP));
+}
+
+void SocketSink::send_stream(){
+    int fd = _fd.load(memory_order_relaxed);
+    bool waited = false;
+    while (_off < _back.size()){
+        ssize_t w = ::send(fd, _back.data() + _off, _back.size() - _off, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR){
+            continue;
+        }
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+            if (waited || !wait_writable(_cfg.batch_interval)){
+                return;                                                             ///> collector slow: rest stays buffered
+            }
+            waited = true;
+            continue;
+        }
+        if (w <= 0){
+            disconnect();                                                           ///> reconnect after retry_interval
+            _retry_at = steady_clock::now() + _cfg.retry_interval;
+            return;
+        }
+        _off += static_cast<size_t>(w);
+        uint64_t lines = 0;
+        while (_next_frame < _off && _next_frame + frame_size(_back.data() + _next_frame) <= _off){
+            _next_frame += frame_size(_back.data() + _next_frame);
+            ++lines;
+        }
+        _sent.fetch_add(lines, memory_order_relaxed);
+    }
+}
+
+void SocketSink::send_datagrams(){
+    static constexpr size_t BURST = 64;
+    iovec iov[BURST];
+    mmsghdr msg[BURST];
+    unsigned lines[BURST];
+    int fd = _fd.load(memory_order_relaxed);
+    bool waited = false;
+    while (_off < _back.size()){
+        ///> pack whole frames into datagrams
+        size_t k = 0, at = _off;
+        while (k < BURST && at < _back.size()){
+            size_t end = at;
+            lines[k] = 0;
+            while (end < _back.size()){
+                size_t f = frame_size(_back.data() + end);
+                if (end > at && end + f - at > _cfg.max_datagram){
+                    break;
+                }
+                end += f;
+                ++lines[k];
+            }
+            iov[k] = {&_back[at], end - at};
+            memset(&msg[k], 0, sizeof(msg[k]));
+            msg[k].msg_hdr.msg_iov    = &iov[k];
+            msg[k].msg_hdr.msg_iovlen = 1;
+            ++k;
+            at = end;
+        }
+        int r = sendmmsg(fd, msg, static_cast<unsigned>(k), MSG_NOSIGNAL);
+        if (r < 0 && errno == EINTR){
+            continue;
+        }
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)){
+            if (waited || !wait_writable(_cfg.batch_interval)){
+                return;                                                             ///> receiver queue full: rest stays buffered
+            }
+            waited = true;
+            continue;
+        }
+        if (r <= 0){
+            disconnect();                                                           ///> receiver gone (ECONNREFUSED, ENOENT ...)
+            _retry_at = steady_clock::now() + _cfg.retry_interval;
+            return;
+        }
+        uint64_t n = 0;
+        for (int i = 0; i < r; ++i){
+            _off += iov[i].iov_len;
+            n += lines[i];
+        }
+        _next_frame = _off;
+        _sent.fetch_add(n, memory_order_relaxed);
+    }
+}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <LogSink.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  SocketSink                                                                                                      //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Lines shipped to a local collector over a socket, many per system call
+*   - "unix:/run/collector.sock", "tcp:host:port" (stream) or "unixgram:/run/collector.sock", "udp:host:port" (datagram)
+*   - loggers only append framed lines to a userspace buffer; an own I/O thread sends it (stream: one send() per
+*     batch; datagram: lines packed into datagrams of max_datagram bytes, up to 64 datagrams per sendmmsg())
+*   - the socket is non-blocking: connecting, reconnecting (every retry_interval) and a slow collector never
+*     stall a logger; beyond max_pending buffered bytes new lines are dropped and counted (dropped())
+*   - a line cut by a broken stream connection is dropped too; the next connection starts at a line boundary
+*   - udp has no back pressure: datagrams the receiver's socket buffer cannot hold are lost without a count
+*
+*   frame   : uint32 length (little-endian), line without its '\n'
+*   datagram: one or more whole frames (lines longer than a datagram are cut)
+*/
+class SocketSink : public LogSink{
+public:
+    struct config{
+        size_t          batch_bytes             {64 << 10};                         ///> send when this much is buffered
+        std::chrono::milliseconds batch_interval {100};                             ///> send at least this often
+        unsigned        flush_level             {1};                                ///> send right away for LOG_ERR/LOG_WARN
+        size_t          max_pending             {4 << 20};                          ///> drop new lines beyond this backlog
+        size_t          max_datagram            {0};                                ///> datagram size, 0 = 16KB unixgram / 1472 udp
+        std::chrono::milliseconds retry_interval {500};                             ///> between connection attempts
+    };
+
+    /*
+    *   Construct
+    */
+    explicit            SocketSink              (const std::string&);               ///> Default config
+                        SocketSink              (const std::string&, const config&);
+    inline              SocketSink              (SocketSink& _src)      = delete;   ///> Copy semantics
+    inline              SocketSink& operator=   (SocketSink const&)     = delete;
+                        ~SocketSink             () override;                        ///> Send what the collector takes within a second & close
+
+    /*
+    *   SYSTEM CONTROL
+    */
+    void                write                   (const char*, size_t, unsigned) override;
+    void                flush                   () override;                        ///> Wait for one send attempt of everything buffered
+    void                emergency_flush         () override;                        ///> Datagram sockets: send the front buffer unless it is locked
+    bool                emergency_write         (const char*, size_t) override;     ///> Datagram sockets: send the line as one frame (cut at 1 KB)
+    inline bool         batched                 () const override { return false; } ///> one frame per line
+    inline bool         is_connected            () const { return _fd.load(std::memory_order_relaxed) >= 0; }
+    inline uint64_t     sent                    () const { return _sent.load(std::memory_order_relaxed); }
+    inline uint64_t     dropped                 () const { return _dropped.load(std::memory_order_relaxed); }
+    inline const std::string& address           () const { return _address; }
+
+    /*
+    *   Receiver side (collectors, cpp_up_logrecv)
+    */
+    static int          listen_socket           (const std::string&);               ///> Bound (& listening) socket of an address, -1 on error
+    static bool         is_stream               (const std::string&);               ///> unix: & tcp: addresses
+
+private:
+    void                io_loop                 ();
+    bool                connect_socket          ();
+    void                send_stream             ();
+    void                send_datagrams          ();
+    bool                wait_writable           (std::chrono::milliseconds);
+    void                disconnect              ();
+
+    std::string         _address;
+    config              _cfg;
+    bool                _stream;
+    size_t              _max_line;                                                  ///> longest line that fits a frame
+    std::atomic<int>    _fd                     {-1};
+    std::chrono::steady_clock::time_point _retry_at {};
+
+    std::string         _front;                                                     ///> filled by loggers
+    std::string         _back;                                                      ///> sent by I/O thread, from _off
+    size_t              _off                    {0};
+    size_t              _next_frame             {0};                                ///> start of the first frame not completely sent
+    size_t              _backlog                {0};                                ///> unsent bytes of _back (guarded by _mutex)
+    std::atomic<uint64_t> _sent                 {0};
+    std::atomic<uint64_t> _dropped              {0};
+    std::mutex          _mutex;
+    std::condition_variable _io_cv;
+    std::condition_variable _done_cv;
+    bool                _kick                   {false};
+    bool                _stop                   {false};
+    uint64_t            _flush_req              {0};
+    uint64_t            _flush_done             {0};
+    std::thread         _io;
+};
+
+}
@@ -0,0 +1,157 @@
+#include <LogTime.hpp>
+
+#include <cstring>
+#include <ctime>
+
+using namespace std;
+using namespace chrono;
+
+namespace cpp_up{
+
+thread_local LogTime::slots LogTime::_tl;
+
+char* LogTime::put_digits(char* p, unsigned v, int w){
+    for (int i = w - 1; i >= 0; --i){
+        p[i] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    }
+    return p + w;
+}
+
+char* LogTime::put_str(char* p, const char* s){
+    size_t n = strlen(s);
+    memcpy(p, s, n);
+    return p + n;
+}
+
+size_t LogTime::render_module(const stamp& c, const struct tm& t, bool color, char* buf, size_t& frac_pos){
+    unsigned fmt  = _fmt.load(memory_order_relaxed);
+    bool utc      = fmt == args::LOG_TIME_UTC || fmt == args::LOG_TIME_ISO8601_UTC;
+    bool iso      = fmt == args::LOG_TIME_ISO8601 || fmt == args::LOG_TIME_ISO8601_UTC;
+
+    char* p = buf;
+    p = put_str(p, color ? "\033[1;31m[\033[0;0m " : "[ ");
+    if (iso){
+        if (color) p = put_str(p, "\033[0;96m");
+        p = put_digits(p, t.tm_year + 1900, 4); *p++ = '-';
+        p = put_digits(p, t.tm_mon + 1, 2);     *p++ = '-';
+        p = put_digits(p, t.tm_mday, 2);        *p++ = 'T';
+    }
+    else if (color){
+        p = put_str(p, "\033[0;34mD \033[0;96m");
+        p = put_digits(p, t.tm_year + 1900, 4); *p++ = '-';
+        p = put_digits(p, t.tm_mon + 1, 2);     *p++ = '-';
+        p = put_digits(p, t.tm_mday, 2);
+        p = put_str(p, "; \033[0;34mT \033[0;96m");
+    }
+    else{
+        p = put_str(p, "D ");
+        p = put_digits(p, t.tm_mday, 2);        *p++ = '.';
+        p = put_digits(p, t.tm_mon + 1, 2);     *p++ = '.';
+        p = put_digits(p, t.tm_year + 1900, 4);
+        p = put_str(p, "; T ");
+    }
+    p = put_digits(p, t.tm_hour, 2); *p++ = ':';
+    p = put_digits(p, t.tm_min, 2);  *p++ = ':';
+    p = put_digits(p, t.tm_sec, 2);
+    frac_pos = 0;
+    if (c.frac_digits > 0){
+        *p++ = '.';
+        frac_pos = static_cast<size_t>(p - buf);
+        p = put_digits(p, 0, c.frac_digits);
+    }
+    if (iso && utc){
+        *p++ = 'Z';
+    }
+    else if (iso){
+        memcpy(p, c.zone, sizeof(c.zone));
+        p += sizeof(c.zone);
+    }
+    p = put_str(p, color ? " \033[1;31m]\033[0;0m" : " ]");
+    return static_cast<size_t>(p - buf);
+}
+
+void LogTime::render(stamp& c, int64_t sec){
+    unsigned fmt  = _fmt.load(memory_order_relaxed);
+    unsigned prec = _prec.load(memory_order_relaxed);
+    bool utc      = fmt == args::LOG_TIME_UTC || fmt == args::LOG_TIME_ISO8601_UTC;
+
+    time_t tt = static_cast<time_t>(sec);
+    struct tm t;
+#if defined(_WIN32)
+    if (utc) gmtime_s(&t, &tt); else localtime_s(&t, &tt);
+    long off = utc ? 0 : -_timezone + (t.tm_isdst > 0 ? 3600 : 0);
+#else
+    if (utc) gmtime_r(&tt, &t); else localtime_r(&tt, &t);
+    long off = utc ? 0 : t.tm_gmtoff;
+#endif
+
+    char* p = c.digits;
+    p = put_digits(p, t.tm_year + 1900, 4);
+    p = put_digits(p, t.tm_mon + 1, 2);
+    p = put_digits(p, t.tm_mday, 2);
+    p = put_digits(p, t.tm_hour, 2);
+    p = put_digits(p, t.tm_min, 2);
+    put_digits(p, t.tm_sec, 2);
+
+    c.zone[0] = off < 0 ? '-' : '+';
+    off = off < 0 ? -off : off;
+    put_digits(c.zone + 1, static_cast<unsigned>(off / 3600), 2);
+    c.zone[3] = ':';
+    put_digits(c.zone + 4, static_cast<unsigned>(off % 3600 / 60), 2);
+
+    c.frac_digits = prec == args::LOG_TIME_USEC ? 6 : (prec == args::LOG_TIME_MSEC ? 3 : 0);
+    c.len[0] = render_module(c, t, false, c.module[0], c.frac_pos[0]);
+    c.len[1] = render_module(c, t, true, c.module[1], c.frac_pos[1]);
+    c.sec    = sec;
+    c.owner  = _id;
+}
+
+LogTime::stamp& LogTime::lookup(system_clock::time_point tp){
+    int64_t us  = duration_cast<microseconds>(tp.time_since_epoch()).count();
+    int64_t sec = us >= 0 ? us / 1000000 : (us - 999999) / 1000000;
+    uint32_t gen = _gen.load(memory_order_acquire);
+
+    stamp* c = nullptr;
+    for (stamp& s : _tl.s){
+        if (s.owner == _id){
+            c = &s;
+            break;
+        }
+    }
+    if (!c){
+        c = &_tl.s[_tl.next++ % _tl.s.size()];
+        c->owner = _id;
+        c->sec   = -1;
+    }
+    if (c->sec != sec || c->gen != gen){
+        c->gen = gen;
+        render(*c, sec);
+    }
+    c->usec = static_cast<unsigned>(us - sec * 1000000);
+    return *c;
+}
+
+const LogTime::stamp& LogTime::at(system_clock::time_point tp){
+    return lookup(tp);
+}
+
+void LogTime::append(string& line, system_clock::time_point tp, bool color){
+    stamp& c = lookup(tp);
+    if (c.frac_pos[color] != 0){
+        put_digits(c.module[color] + c.frac_pos[color], c.frac_digits == 3 ? c.usec / 1000 : c.usec, c.frac_digits);
+    }
+    line.append(c.module[color], c.len[color]);
+}
+
+void LogTime::set_format(unsigned _f){
+    _fmt.store(_f, memory_order_relaxed);
+    _gen.fetch_add(1, memory_order_release);
+}
+
+void LogTime::set_precision(unsigned _p){
+    _prec.store(_p, memory_order_relaxed);
+    _gen.fetch_add(1, memory_order_release);
+}
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <LogArgs.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogTime                                                                                                         //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Timestamp engine of the Logger time module
+*   - everything that depends on the second is rendered once per second per thread (localtime_r/gmtime_r + digits):
+*     the plain & colored time module and the raw date digits used by pattern fields
+*   - a thread keeps one stamp for each of the last few LogTimes it used (one per Logger instance),
+*     so alternating between loggers keeps every cache warm
+*   - lines within the same second copy the cached text and patch only the sub-second digits
+*   - any style change bumps the generation counter, which invalidates every thread cache lazily
+*/
+class LogTime{
+public:
+    /*
+    *   Per-thread cache of one second
+    */
+    struct stamp{
+        uint64_t        owner                   {0};                                ///> LogTime::_id (an address can be reused)
+        uint32_t        gen                     {0};
+        int64_t         sec                     {-1};
+        unsigned        usec                    {0};                                ///> sub-second part of the last lookup
+        char            digits[14];                                                 ///> YYYYmmddHHMMSS
+        char            zone[6];                                                    ///> +hh:mm
+        int             frac_digits             {0};
+        size_t          len[2]                  {0, 0};                             ///> plain / colored time module
+        size_t          frac_pos[2]             {0, 0};
+        char            module[2][160];
+    };
+
+    /*
+    *   SYSTEM CONTROL
+    */
+    const stamp&        at                      (std::chrono::system_clock::time_point); ///> Cached second + sub-second of a time point
+    void                append                  (std::string&, std::chrono::system_clock::time_point, bool color); ///> Render time module into line
+
+    /*
+    *   SYSTEM SETUP
+    */
+    void                set_format              (unsigned);                         ///> args::l_time_fmt
+    void                set_precision           (unsigned);                         ///> args::l_time_prec
+
+private:
+    stamp&              lookup                  (std::chrono::system_clock::time_point); ///> Stamp of this LogTime for the calling thread, current
+    void                render                  (stamp&, int64_t);                 ///> Rebuild cache for a new second
+    size_t              render_module           (const stamp&, const struct tm&, bool color, char*, size_t&);
+    static char*        put_digits              (char*, unsigned, int);            ///> Zero-padded fixed-width integer
+    static char*        put_str                 (char*, const char*);
+
+    struct slots{
+        std::array<stamp, 4> s;
+        unsigned        next                    {0};                                ///> replaced next when all are taken
+    };
+    static thread_local slots _tl;
+    inline static std::atomic<uint64_t> _ids    {0};
+    const uint64_t      _id                     {_ids.fetch_add(1, std::memory_order_relaxed) + 1};
+    std::atomic<uint32_t> _gen                  {1};
+    std::atomic<unsigned> _fmt                  {args::LOG_TIME_LOCAL};
+    std::atomic<unsigned> _prec                 {args::LOG_TIME_SEC};
+};
+
+}
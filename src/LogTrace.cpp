@@ -0,0 +1,285 @@
+#include <LogTrace.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std;
+using namespace chrono;
+
+namespace cpp_up{
+
+struct LogTrace::registry{
+    atomic<size_t>          limit           {1 << 20};
+    atomic<uint64_t>        dropped         {0};
+    mutex                   mtx;
+    vector<string>          names           {""};                                   ///> id 0: unnamed "E"
+    unordered_map<string, uint32_t> ids;
+    vector<thread_buf*>     threads;
+    vector<thread_buf*>     spare;                                                  ///> emptied, of exited threads
+    atomic<uint64_t>        clears          {0};
+    mutex                   io;                                                     ///> export & clear: chunks are freed (before mtx)
+};
+
+LogTrace::registry& LogTrace::reg(){
+    static registry& r = *new registry;                                             ///> buffers outlive every thread
+    return r;
+}
+
+void LogTrace::set_enabled(bool on, size_t limit){
+    registry& r = reg();
+    r.limit.store(limit, memory_order_relaxed);
+    _on.store(on, memory_order_relaxed);
+}
+
+uint32_t LogTrace::intern(const string& n){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    auto it = r.ids.find(n);
+    if (it != r.ids.end()){
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(r.names.size());
+    r.names.push_back(n);
+    r.ids.emplace(n, id);
+    return id;
+}
+
+LogTrace::thread_buf& LogTrace::local(){
+    struct handle{
+        thread_buf*     buf     {nullptr};
+        ~handle(){
+            if (buf){
+                retire(*buf);
+            }
+        }
+    };
+    static thread_local handle tl;
+    if (tl.buf){
+        return *tl.buf;
+    }
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    thread_buf* b;
+    if (!r.spare.empty()){
+        b = r.spare.back();                                                         ///> one empty chunk, invisible to exporters
+        r.spare.pop_back();
+        b->tail   = b->head;
+        b->exited = false;
+    }
+    else{
+        chunk* c = new chunk;
+        b = new thread_buf{0, c, c, 0};
+    }
+    b->tid    = log_thread_id();
+    b->count  = 0;
+    b->open.clear();
+    b->owed   = 0;
+    b->clears = r.clears.load(memory_order_relaxed);
+    r.threads.push_back(b);
+    tl.buf = b;
+    return *b;
+}
+
+void LogTrace::retire(thread_buf& b){
+    registry& r = reg();
+    lock_guard<mutex> lock(r.io);
+    b.exited = true;
+    cut(b, b.head, b.skip);                                                         ///> nothing dropped: reused if already empty
+}
+
+void LogTrace::cut(thread_buf& b, chunk* to, size_t n){
+    while (b.head != to){
+        chunk* next = b.head->next.load(memory_order_acquire);
+        delete b.head;                                                              ///> the owner only writes the tail
+        b.head = next;
+    }
+    b.skip = n;
+    if (!b.exited || to->next.load(memory_order_acquire) || to->n.load(memory_order_acquire) != n){
+        return;
+    }
+    to->n.store(0, memory_order_relaxed);
+    b.skip = 0;
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    r.threads.erase(find(r.threads.begin(), r.threads.end(), &b));
+    r.spare.push_back(&b);
+}
+
+void LogTrace::clear(){
+    registry& r = reg();
+    lock_guard<mutex> io(r.io);
+    vector<thread_buf*> threads;
+    {
+        lock_guard<mutex> lock(r.mtx);
+        threads = r.threads;
+    }
+    for (thread_buf* b : threads){
+        chunk* c = b->head;
+        while (chunk* next = c->next.load(memory_order_acquire)){
+            c = next;
+        }
+        cut(*b, c, c->n.load(memory_order_acquire));
+    }
+    r.dropped.store(0, memory_order_relaxed);
+    r.clears.fetch_add(1, memory_order_relaxed);                                    ///> owners restart their limit
+}
+
+void LogTrace::push(char ph, uint32_t name, uint64_t ns, uint64_t dur){
+    thread_buf& b = local();
+    registry& r = reg();
+    uint64_t clears = r.clears.load(memory_order_relaxed);
+    if (clears != b.clears){
+        b.clears = clears;
+        b.count  = 0;
+        b.open.assign(b.open.size(), false);                                        ///> their "B" is gone: drop the "E" too
+        b.owed   = 0;
+    }
+    if (ph == 'E' && !b.open.empty()){
+        bool kept = b.open.back();
+        b.open.pop_back();
+        if (!kept){
+            r.dropped.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+        --b.owed;                                                                   ///> its room was reserved by the "B"
+    }
+    else{
+        bool room = b.count + b.owed + (ph == 'B' ? 2 : 1) <= r.limit.load(memory_order_relaxed);
+        if (ph == 'B'){
+            b.open.push_back(room);
+            b.owed += room;
+        }
+        if (!room){
+            r.dropped.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+    }
+    chunk* c = b.tail;
+    size_t n = c->n.load(memory_order_relaxed);
+    if (n == c->ev.size()){
+        chunk* fresh = new chunk;
+        c->next.store(fresh, memory_order_release);
+        b.tail = c = fresh;
+        n = 0;
+    }
+    c->ev[n] = event{ns, dur, name, ph};
+    c->n.store(n + 1, memory_order_release);
+    ++b.count;
+}
+
+size_t LogTrace::write_json(ostream& out, bool clear){
+    registry& r = reg();
+    lock_guard<mutex> io(r.io);
+    vector<thread_buf*> threads;
+    vector<string> names;
+    {
+        lock_guard<mutex> lock(r.mtx);
+        threads = r.threads;
+        names   = r.names;
+    }
+    uint64_t epoch = UINT64_MAX;                                                    ///> first event is ts 0
+    for (thread_buf* b : threads){
+        for (chunk* c = b->head; c; c = c->next.load(memory_order_acquire)){
+            size_t n = c->n.load(memory_order_acquire);
+            for (size_t i = c == b->head ? b->skip : 0; i < n; ++i){
+                epoch = min(epoch, c->ev[i].ns);
+            }
+        }
+    }
+    const string pid = to_string(getpid());
+
+    ///> "us.nnn" from ns, relative to the trace epoch
+    auto append_us = [](string& s, uint64_t ns){
+        char buf[24];
+        to_chars_result res = to_chars(buf, buf + sizeof(buf), ns / 1000);
+        s.append(buf, static_cast<size_t>(res.ptr - buf));
+        unsigned frac = static_cast<unsigned>(ns % 1000);
+        s += '.';
+        s += static_cast<char>('0' + frac / 100);
+        s += static_cast<char>('0' + frac / 10 % 10);
+        s += static_cast<char>('0' + frac % 10);
+    };
+    auto append_name = [](string& s, const string& n){
+        static const char hex[] = "0123456789abcdef";
+        for (char c : n){
+            if (c == '"' || c == '\\'){
+                s += '\\';
+                s += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20){
+                s.append("\\u00");
+                s += hex[(c >> 4) & 0xF];
+                s += hex[c & 0xF];
+            }
+            else{
+                s += c;
+            }
+        }
+    };
+
+    size_t count = 0;
+    string line;
+    vector<pair<chunk*, size_t>> done;                                              ///> per thread: end of the exported events
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (thread_buf* b : threads){
+        const string tid = to_string(b->tid);
+        done.emplace_back(b->head, b->skip);
+        for (chunk* c = b->head; c; c = c->next.load(memory_order_acquire)){
+            size_t n = c->n.load(memory_order_acquire);
+            done.back() = {c, n};
+            for (size_t i = c == b->head ? b->skip : 0; i < n; ++i){
+                const event& e = c->ev[i];
+                line.assign(count ? ",\n{" : "\n{");
+                if (e.ph != 'E'){
+                    line.append("\"name\":\"");
+                    append_name(line, e.name < names.size() ? names[e.name] : string());
+                    line.append("\",");
+                }
+                line.append("\"ph\":\"").append(1, e.ph).append("\",\"ts\":");
+                append_us(line, e.ns - epoch);
+                if (e.ph == 'X'){
+                    line.append(",\"dur\":");
+                    append_us(line, e.dur);
+                }
+                if (e.ph == 'i'){
+                    line.append(",\"s\":\"t\"");
+                }
+                line.append(",\"pid\":").append(pid).append(",\"tid\":").append(tid).append("}");
+                out << line;
+                ++count;
+            }
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    if (clear){
+        for (size_t i = 0; i < threads.size(); ++i){
+            cut(*threads[i], done[i].first, done[i].second);                        ///> later events are kept
+        }
+        r.dropped.store(0, memory_order_relaxed);
+        r.clears.fetch_add(1, memory_order_relaxed);
+    }
+    return count;
+}
+
+uint64_t LogTrace::dropped(){
+    return reg().dropped.load(memory_order_relaxed);
+}
+
+bool LogTrace::save(const string& path, bool clear){
+    ofstream f(path, ios::binary | ios::trunc);
+    if (!f){
+        return false;
+    }
+    write_json(f, clear);
+    return static_cast<bool>(f);
+}
+
+}
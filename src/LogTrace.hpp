@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <LogClock.hpp>
+#include <LogLayout.hpp>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogTrace                                                                                                        //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Span recorder with Chrome trace-event JSON export (chrome://tracing, ui.perfetto.dev)
+*   - off by default: a disabled call is one relaxed load
+*   - every thread appends to its own chunk list (no lock, no RMW); the exporter reads published events only
+*   - names are interned once (keep the id in a static, see LOG_TRACE_SCOPE)
+*   - buffers outlive their threads; each thread keeps at most `limit` events, the rest is counted as dropped
+*     (a "B" is kept only with room left for its "E", the "E" of a dropped or cleared "B" is dropped: slices stay balanced)
+*   - clear() (or an export with clear) frees the exported chunks; an emptied buffer of an exited thread is reused
+*/
+class LogTrace{
+public:
+    static void             set_enabled         (bool, size_t limit = 1 << 20);     ///> Start/stop recording, limit = events per thread
+    static inline bool      enabled             () { return _on.load(std::memory_order_relaxed); }
+    static uint32_t         intern              (const std::string&);               ///> Id of a span name
+    static inline uint64_t  now                 () { return LogClock::now(); }      ///> Trace clock, ns
+
+    static inline void      begin               (uint32_t);                         ///> "B" event
+    static inline void      end                 ();                                 ///> "E" event, closes the last begin() of the thread
+    static inline void      instant             (uint32_t);                         ///> "i" event
+    static inline void      complete            (uint32_t, uint64_t, uint64_t);     ///> "X" event: name, start ns, duration ns
+
+    static size_t           write_json          (std::ostream&, bool clear = false); ///> Export every thread, returns event count (clear: drop what was exported)
+    static bool             save                (const std::string&, bool clear = false); ///> write_json() into a file
+    static void             clear               ();                                 ///> Drop every recorded event & the dropped count
+    static uint64_t         dropped             ();
+
+private:
+    struct event{
+        uint64_t        ns;
+        uint64_t        dur;
+        uint32_t        name;
+        char            ph;
+    };
+    struct chunk{
+        std::array<event, 1024> ev;
+        std::atomic<size_t>     n               {0};                                ///> published events
+        std::atomic<chunk*>     next            {nullptr};
+    };
+    struct thread_buf{
+        uint64_t        tid;
+        chunk*          head;                                                       ///> first kept chunk (registry io lock)
+        chunk*          tail;                                                       ///> owner only
+        size_t          count;                                                      ///> owner only
+        size_t          skip            {0};                                        ///> cleared events of head (io lock)
+        uint64_t        clears          {0};                                        ///> owner: clear() count at the last count reset
+        std::vector<bool> open          {};                                         ///> owner: per open begin(), its "B" was kept
+        size_t          owed            {0};                                        ///> owner: kept open spans, room reserved for their "E"
+        bool            exited          {false};                                    ///> io lock
+    };
+    struct registry;
+
+    static registry&            reg             ();
+    static thread_buf&          local           ();
+    static void                 push            (char, uint32_t, uint64_t, uint64_t);
+    static void                 cut             (thread_buf&, chunk*, size_t);      ///> Drop the events before (chunk, index), io lock held
+    static void                 retire          (thread_buf&);                      ///> Owner thread ends: reused once emptied
+
+    inline static std::atomic<bool> _on         {false};                            ///> read by every span
+};
+
+/*
+*   RAII span: begin() now, end() when the scope closes (nothing if tracing was off at begin)
+*/
+class TraceSpan{
+public:
+    inline explicit     TraceSpan               (uint32_t id) : _on(LogTrace::enabled()) { if (_on) LogTrace::begin(id); }
+    inline explicit     TraceSpan               (const std::string& n) : TraceSpan(LogTrace::intern(n)) {} ///> Name lookup per call
+    inline              TraceSpan               (const TraceSpan&)          = delete;
+    inline              TraceSpan& operator=    (const TraceSpan&)          = delete;
+    inline              ~TraceSpan              () { if (_on) LogTrace::end(); }
+
+private:
+    bool                _on;
+};
+
+/*
+*   Trace the rest of the enclosing scope under a name, with a static name id per statement
+*/
+#define LOG_CONCAT_(A, B)   A##B
+#define LOG_CONCAT(A, B)    LOG_CONCAT_(A, B)
+#define LOG_TRACE_SCOPE(N)  static const uint32_t LOG_CONCAT(_log_trace_, __LINE__) = cpp_up::LogTrace::intern((N)); \
+                            cpp_up::TraceSpan LOG_CONCAT(_log_span_, __LINE__) (LOG_CONCAT(_log_trace_, __LINE__))
+
+
+
+void LogTrace::begin(uint32_t name){
+    if (enabled()){
+        push('B', name, now(), 0);
+    }
+}
+
+void LogTrace::end(){
+    if (enabled()){
+        push('E', 0, now(), 0);
+    }
+}
+
+void LogTrace::instant(uint32_t name){
+    if (enabled()){
+        push('i', name, now(), 0);
+    }
+}
+
+void LogTrace::complete(uint32_t name, uint64_t start, uint64_t dur){
+    if (enabled()){
+        push('X', name, start, dur);
+    }
+}
+
+}
@@ -0,0 +1,60 @@
+#include <LogTty.hpp>
+
+#include <iostream>
+
+#include <unistd.h>
+
+using namespace std;
+
+namespace cpp_up{
+
+bool LogTty::is_tty(const ostream& f){
+    const streambuf* b = f.rdbuf();
+    if (b == nullptr){
+        return false;
+    }
+    if (b == cout.rdbuf()){
+        return ::isatty(STDOUT_FILENO) == 1;
+    }
+    if (b == cerr.rdbuf() || b == clog.rdbuf()){
+        return ::isatty(STDERR_FILENO) == 1;
+    }
+    return false;
+}
+
+void LogTty::strip(string& out, string_view s){
+    const char* p   = s.data();
+    const char* end = p + s.size();
+    while (p < end){
+        const char* e = static_cast<const char*>(memchr(p, '\033', static_cast<size_t>(end - p)));
+        if (e == nullptr){
+            out.append(p, static_cast<size_t>(end - p));
+            return;
+        }
+        out.append(p, static_cast<size_t>(e - p));
+        p = e + 1;
+        if (p == end){
+            return;
+        }
+        if (*p == '['){                                                             ///> CSI: parameters & intermediates, then a final byte
+            ++p;
+            while (p < end && static_cast<unsigned char>(*p) >= 0x20 && static_cast<unsigned char>(*p) <= 0x3F){
+                ++p;
+            }
+            if (p < end && static_cast<unsigned char>(*p) >= 0x40 && static_cast<unsigned char>(*p) <= 0x7E){
+                ++p;
+            }
+        }
+        else if (*p == ']'){                                                        ///> OSC: up to BEL or ESC '\'
+            while (p < end && *p != '\a' && !(*p == '\033' && p + 1 < end && p[1] == '\\')){
+                ++p;
+            }
+            p += p < end && *p == '\a' ? 1 : p < end ? 2 : 0;
+        }
+        else{
+            ++p;
+        }
+    }
+}
+
+}
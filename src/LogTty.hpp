@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstring>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace cpp_up{
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  LogTty                                                                                                          //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+*   Terminal detection & ANSI escape removal for plain outputs (files, pipes, memory)
+*   - is_tty(): a stream writing through the buffer of cout (fd 1) or cerr/clog (fd 2) and isatty() on that fd;
+*     other streams (ofstream, stringstream, custom buffers) count as no terminal, callers offer an override
+*   - strip(): removes CSI ("\033[...m", cursor moves), OSC ("\033]...BEL") and 2-byte escapes; clean runs
+*     between ESC bytes are found with memchr (vectorized in libc) and appended in bulk
+*/
+class LogTty{
+public:
+    static bool         is_tty                  (const std::ostream&);
+    static void         strip                   (std::string&, std::string_view);   ///> Append text without escape sequences
+    static inline bool  has_escape              (std::string_view s) { return memchr(s.data(), '\033', s.size()) != nullptr; }
+};
+
+}
@@ -0,0 +1,1197 @@
+#include <Logger.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+#include <LogBinary.hpp>
+#include <LogClock.hpp>
+#include <LogCompress.hpp>
+#include <LogCrash.hpp>
+#include <LogFile.hpp>
+#include <LogLayout.hpp>
+#include <LogMmap.hpp>
+#include <LogProfile.hpp>
+#include <LogQueue.hpp>
+#include <LogRepeat.hpp>
+#include <LogShm.hpp>
+#include <LogSocket.hpp>
+#include <LogTrace.hpp>
+
+using namespace std;
+using namespace chrono;
+
+namespace cpp_up{
+
+struct Logger::impl{
+    struct writer{
+        thread                  th;
+        mutex                   mtx;
+        condition_variable      cv;
+        mutex                   space_mtx;
+        condition_variable      space_cv;                                           ///> LOG_ASYNC_BLOCK: a full queue got free slots
+        thread                  sweep;                                              ///> coalescing on: writes expired summaries
+        condition_variable      sweep_cv;
+        bool                    sweep_stop  {false};
+    };
+
+    struct entry{
+        string          body;
+        string          fields;
+        unsigned        level;
+        system_clock::time_point time;
+        const char*     file;
+        unsigned        line;
+        uint64_t        thread;
+    };
+
+    struct sink_entry{
+        shared_ptr<LogSink> sink;
+        unsigned        level;                                                      ///> most verbose level written
+        unsigned        colors;                                                     ///> args::l_style or LOG_COLORS_INHERIT
+        unsigned        format;                                                     ///> args::l_format
+        unsigned        tty;                                                        ///> args::l_tty
+        bool            terminal;                                                   ///> sink->is_tty() when attached
+        unsigned        style;                                                      ///> resolved color style, STYLE_JSON or STYLE_PLAIN
+        bool            stream;                                                     ///> ostream: flushed after every async batch
+        bool            batched;                                                    ///> sink->batched(): async writer joins lines
+        string          batch;                                                      ///> async writer only
+        unsigned        batch_level;
+    };
+
+    struct crash_sink{
+        LogSink*        sink;
+        unsigned        level;
+    };
+
+    explicit impl(Logger& _self) : self(_self) {}
+    ~impl() { delete _crash_sinks.load(); }
+
+    static void         sink_write              (LogSink&, const char*, size_t, unsigned); ///> write(), under the sink lock if shared
+    static void         sink_flush              (LogSink&);                         ///> flush(), same
+    void                commit                  (const LogRecord&);                 ///> Coalesce repeats, then emit
+    void                emit                    (const LogRecord&);                 ///> Render record & hand it over
+    bool                coalesce                (const LogRecord&, int64_t);        ///> Count a repeat of the thread's last line (true), else write its pending summary
+    LogRepeat&          repeat_state            ();                                 ///> Coalescing state of the calling thread, registered on first use
+    void                flush_repeats           (bool expired = false);             ///> Write pending summaries of all threads (expired: only past the window), drop states of exited ones
+    void                sweep_loop              ();                                 ///> Writes summaries whose window ended while their thread stays quiet
+    void                stop_sweep              ();
+    bool                enqueue                 (const LogRecord&);                 ///> Hand record to async writer (false: async is off by now)
+    void                write_sinks             (const LogRecord&, const vector<LogLayout>&, uint32_t); ///> Write line to every sink (holds _write_mutex)
+    void                batch_entry             (const entry&, const vector<LogLayout>&); ///> Render queued record into sink batches (holds _write_mutex)
+    void                write_batches           ();                                 ///> Write & reset sink batches (holds _write_mutex)
+    void                writer_loop             ();                                 ///> Background writer: drain queue in batches
+    void                stop_writer             ();                                 ///> Join writer after draining the queue
+    void                rebuild_layout          ();                                 ///> Compile pattern/modules into new layouts (holds _mutex)
+    void                attach                  (const shared_ptr<LogSink>&, unsigned, unsigned); ///> Register sink (holds _mutex + _write_mutex)
+    void                detach                  (const shared_ptr<LogSink>&);       ///> Unregister sink (holds _mutex + _write_mutex)
+    void                update_routes           ();                                 ///> Resolve sink styles & per-level style masks (holds _mutex + _write_mutex)
+    void                publish_crash_sinks     ();                                 ///> Swap the sink list emergency_flush() reads (holds _mutex + _write_mutex)
+    const vector<LogLayout>& layouts            ();                                 ///> Current layout per color style, cached per thread
+    static array<string, 6> style_colors        (unsigned);                         ///> Level colors of a color style
+    static void         render_line             (string&, const LogLayout&, const LogRecord&, LogTime&);
+
+    inline static atomic<uint64_t> _ids         {0};
+    Logger&             self;
+    const uint64_t      _id                     {_ids.fetch_add(1, memory_order_relaxed) + 1}; ///> key of per-thread caches
+    LogTime             _time;
+    uint64_t            _now                    {LogClock::now()};                  ///> LogClock ns
+    uint64_t            _start                  {_now};
+    vector<uint64_t>    _snaps;
+    vector<string>      _snap_ns;
+    vector<sink_entry>  _sinks;
+    atomic<const vector<crash_sink>*> _crash_sinks {nullptr};                       ///> immutable copy of _sinks for emergency_flush()
+    atomic<unsigned>    _crash_readers          {0};                                ///> emergency_flush() calls holding a copy
+    array<atomic<uint32_t>, 7> _routes          {};                                 ///> per level: bit mask of styles some sink needs
+    shared_ptr<FileSink> _file;
+    FileSink::config    _file_cfg;
+    string              _file_path              {""};
+    bool                _file_compress          {false};
+    shared_ptr<MmapSink> _mmap;
+    shared_ptr<ShmSink> _shm;
+    shared_ptr<SocketSink> _socket;
+    unique_ptr<LogBinary> _binary;
+    atomic<int64_t>     _coalesce_ns            {0};                                ///> read on every line
+    mutex               _repeat_mutex;
+    vector<shared_ptr<LogRepeat>> _repeats;                                         ///> per thread, shared with a thread_local handle
+    bool                _f_time                 {false};
+    bool                _f_stat                 {false};
+    unsigned            _f_color                {0};
+    unsigned            _f_format               {args::LOG_FORMAT_TEXT};
+    string              _pattern                {""};
+    shared_ptr<const vector<LogLayout>> _layouts;
+    atomic<uint32_t>    _layout_gen             {0};
+    mutex               _mutex;
+    mutex               _write_mutex;
+    static thread_local array<string, 7> _log_lines;                                ///> rendered line per style
+    static constexpr unsigned STYLE_JSON        = args::LOG_COLORS_UNDERLINE + 1;   ///> layout index of JSON Lines
+    static constexpr unsigned STYLE_PLAIN       = STYLE_JSON + 1;                   ///> layout index of non-terminal text (escapes stripped)
+
+    unique_ptr<LogQueue<entry>> _queue;
+    writer              _writer;
+    atomic<unsigned>    _async                  {args::LOG_ASYNC_OFF};
+    mutex               _async_mutex;                                               ///> set_log_async() calls
+    atomic<unsigned>    _producers              {0};                                ///> threads inside enqueue(): the queue stays until they left
+    atomic<unsigned>    _blocked                {0};                                ///> LOG_ASYNC_BLOCK producers waiting for a slot
+    atomic<bool>        _writer_stop            {false};
+    atomic<bool>        _writer_idle            {false};
+    atomic<uint64_t>    _dropped                {0};
+    atomic<uint64_t>    _pending                {0};                                ///> queued & not yet written
+    static thread_local entry _push_entry;
+    static thread_local entry _drop_entry;
+    static entry        _crash_entry;                                               ///> swapped out of the queue by emergency_flush()
+};
+
+thread_local array<string, 7>   Logger::impl::_log_lines;
+thread_local Logger::impl::entry Logger::impl::_push_entry;
+thread_local Logger::impl::entry Logger::impl::_drop_entry;
+Logger::impl::entry             Logger::impl::_crash_entry;
+
+struct Logger::registry{
+    struct table{
+        size_t                          mask;
+        unique_ptr<atomic<Logger*>[]>   slots;                                      ///> open addressing by name hash
+        explicit table(size_t n) : mask(n - 1), slots(new atomic<Logger*>[n]()) {}
+    };
+
+    mutex                               mtx;                                        ///> creation only
+    atomic<table*>                      tab     {nullptr};
+    vector<unique_ptr<table>>           tables;                                     ///> outgrown ones too: lookups may still read them
+    vector<unique_ptr<Logger>>          owned;                                      ///> destroyed (drained) at exit
+
+    registry(){
+        tables.emplace_back(new table(NAMED_SLOTS));
+        tab.store(tables.back().get(), memory_order_release);
+    }
+
+    static void insert(table& t, Logger* l){
+        size_t i = hash<string>()(l->_name);
+        while (t.slots[i & t.mask].load(memory_order_relaxed)){
+            ++i;
+        }
+        t.slots[i & t.mask].store(l, memory_order_release);                        ///> published complete
+    }
+};
+
+/*
+*   State a thread keeps per Logger, for the last few Loggers it used (keyed by id: an address can be reused)
+*/
+template <typename T>
+struct per_logger{
+    array<pair<uint64_t, T>, 8> slots   {};
+    unsigned                    next    {0};
+
+    T& at(uint64_t id){
+        for (auto& s : slots){
+            if (s.first == id){
+                return s.second;
+            }
+        }
+        auto& s = slots[next++ % slots.size()];
+        s = {id, T{}};
+        return s.second;
+    }
+};
+
+static mutex& share_mutex(){                                                       ///> LogSink::_owner of every sink
+    static mutex& m = *new mutex;                                                   ///> outlives static Loggers (~Logger locks it)
+    return m;
+}
+
+static shared_ptr<LogSink> stream_sink(ostream& f){                                ///> one OstreamSink per stream, shared by its Loggers
+    static unordered_map<const ostream*, weak_ptr<LogSink>> sinks;
+    lock_guard<mutex> lock(share_mutex());
+    shared_ptr<LogSink> s = sinks[&f].lock();
+    if (!s){
+        s = make_shared<OstreamSink>(f);
+        sinks[&f] = s;
+    }
+    return s;
+}
+
+Logger& Logger::get_instance(ostream& f){
+    static Logger _instance(f);                                                     ///> later streams are ignored: add_sink() them
+    return _instance;
+}
+
+Logger::registry& Logger::reg(){
+    static registry r;
+    return r;
+}
+
+Logger* Logger::find(const string& _name){
+    registry::table& t = *reg().tab.load(memory_order_acquire);
+    size_t h = hash<string>()(_name);
+    for (size_t i = 0; i <= t.mask; ++i){
+        Logger* l = t.slots[(h + i) & t.mask].load(memory_order_acquire);
+        if (!l){
+            return nullptr;
+        }
+        if (l->_name == _name){
+            return l;
+        }
+    }
+    return nullptr;
+}
+
+Logger& Logger::get(const string& _name, ostream& f){
+    if (_name.empty()){
+        return get_instance(f);
+    }
+    if (Logger* l = find(_name)){
+        return *l;
+    }
+    registry& r = reg();
+    lock_guard<mutex> lock(r.mtx);
+    if (Logger* l = find(_name)){
+        return *l;                                                                  ///> created meanwhile
+    }
+    unique_ptr<Logger> l(new Logger(f));
+    l->_name = _name;
+    l->_own_level.store(_loglevel().load(memory_order_relaxed), memory_order_relaxed);
+    l->_level = &l->_own_level;
+    registry::table* t = r.tab.load(memory_order_relaxed);
+    if (r.owned.size() + 1 > (t->mask + 1) / 4 * 3){
+        r.tables.emplace_back(new registry::table((t->mask + 1) * 2));              ///> 3/4 used: double, old one stays readable
+        t = r.tables.back().get();
+        for (unique_ptr<Logger>& o : r.owned){
+            registry::insert(*t, o.get());
+        }
+        r.tab.store(t, memory_order_release);
+    }
+    registry::insert(*t, l.get());
+    r.owned.push_back(move(l));
+    return *r.owned.back();
+}
+
+Logger::Logger(ostream& f, unsigned ll)
+    : Logger(f)
+{
+    LogCategory::set_default(ll);
+}
+
+Logger::Logger(ostream& f)
+    : _impl(new impl(*this))
+{
+    shared_ptr<LogSink> sink = stream_sink(f);
+    share(*sink);
+    _impl->attach(sink, args::LOG_DEBUG, args::LOG_COLORS_INHERIT);
+    set_log_style_colors(args::LOG_COLORS_NONE);
+}
+
+Logger::~Logger(){
+    if (LogCrash::installed(this)){
+        LogCrash::uninstall();
+    }
+    _impl->stop_sweep();
+    _impl->flush_repeats();
+    _impl->stop_writer();
+    lock_guard<mutex> lock(share_mutex());
+    for (impl::sink_entry& s : _impl->_sinks){
+        if (s.sink->_owner == this){
+            s.sink->_owner = nullptr;                                               ///> sink may live on in another Logger
+        }
+    }
+}
+
+void Logger::set_log_level(unsigned ll){
+    if (_level == &_loglevel()){
+        LogCategory::set_default(ll);
+        return;
+    }
+    _level->store(ll, memory_order_relaxed);
+}
+
+void Logger::share(LogSink& _sink){
+    lock_guard<mutex> lock(share_mutex());
+    if (!_sink._owner){
+        _sink._owner = this;
+        return;
+    }
+    if (_sink._owner == this || _sink._shared.load(memory_order_relaxed)){
+        return;
+    }
+    _sink._shared.store(true, memory_order_relaxed);
+    lock_guard<mutex> barrier(_sink._owner->_impl->_write_mutex);                          ///> its unlocked write in progress is done
+}
+
+void Logger::impl::sink_write(LogSink& _sink, const char* p, size_t n, unsigned ll){
+    if (!_sink._shared.load(memory_order_relaxed)){
+        _sink.write(p, n, ll);
+        return;
+    }
+    lock_guard<mutex> lock(_sink._share_mutex);
+    _sink.write(p, n, ll);
+}
+
+void Logger::impl::sink_flush(LogSink& _sink){
+    if (!_sink._shared.load(memory_order_relaxed)){
+        _sink.flush();
+        return;
+    }
+    lock_guard<mutex> lock(_sink._share_mutex);
+    _sink.flush();
+}
+
+void Logger::log_record(const LogRecord& rec){
+    _impl->commit(rec);
+}
+
+void Logger::commit(const expr& e){
+    _impl->commit({e.level, e.time, e.file, e.line, e.msg, 0, _log_fields});
+}
+
+LogBinaryRecord* Logger::begin_binary(LogBinary& bin, LogSite& site, unsigned ll){
+    return &bin.begin(site, ll, system_clock::now());
+}
+
+LogBinaryRecord* Logger::begin_binary(LogBinary& bin, const char* file, unsigned line, unsigned ll){
+    static LogSite anonymous {nullptr, 0};                                          ///> plain log(ll): no call site, nothing cached
+    return begin_binary(bin, file ? LogBinary::site(file, line) : anonymous, ll);
+}
+
+void Logger::impl::commit(const LogRecord& rec){
+    int64_t window = _coalesce_ns.load(memory_order_relaxed);
+    if (window != 0 && coalesce(rec, window)){
+        return;
+    }
+    emit(rec);
+}
+
+void Logger::impl::emit(const LogRecord& rec){
+    if (_async.load(memory_order_relaxed) != args::LOG_ASYNC_OFF && enqueue(rec)){
+        return;                                                                     ///> rendered by the writer
+    }
+    const vector<LogLayout>& lay = layouts();
+    uint32_t mask = _routes[min(rec.level, 6u)].load(memory_order_acquire);
+    for (unsigned st = 0; st < lay.size(); ++st){
+        if (mask >> st & 1){
+            render_line(_log_lines[st], lay[st], rec, _time);                      ///> outside the write lock
+        }
+    }
+    write_sinks(rec, lay, mask);
+}
+
+bool Logger::impl::coalesce(const LogRecord& rec, int64_t window){
+    LogRepeat& r = repeat_state();
+    uint64_t h = LogRepeat::hash(rec);
+    lock_guard<mutex> lock(r.mtx);
+    if (r.repeat(rec, h, window)){
+        return true;
+    }
+    static thread_local string text;
+    LogRecord sum {};
+    if (r.take(text, sum)){
+        emit(sum);                                                                  ///> summary goes before the new line
+    }
+    r.remember(rec, h);
+    return false;
+}
+
+LogRepeat& Logger::impl::repeat_state(){
+    static thread_local per_logger<shared_ptr<LogRepeat>> tl;
+    shared_ptr<LogRepeat>& p = tl.at(_id);
+    if (!p){
+        flush_repeats();                                                            ///> also prunes states of exited threads
+        p = make_shared<LogRepeat>();
+        lock_guard<mutex> lock(_repeat_mutex);
+        _repeats.push_back(p);
+    }
+    return *p;
+}
+
+void Logger::impl::flush_repeats(bool expired){
+    lock_guard<mutex> lock(_repeat_mutex);
+    string text;
+    LogRecord sum {};
+    int64_t window = _coalesce_ns.load(memory_order_relaxed);
+    system_clock::time_point now = system_clock::now();
+    for (size_t i = 0; i < _repeats.size();){
+        {
+            lock_guard<mutex> rlock(_repeats[i]->mtx);
+            if ((!expired || _repeats[i]->expired(now, window)) && _repeats[i]->take(text, sum)){
+                emit(sum);
+            }
+        }
+        if (_repeats[i].use_count() == 1){
+            _repeats[i] = _repeats.back();                                          ///> thread is gone
+            _repeats.pop_back();
+            continue;
+        }
+        ++i;
+    }
+}
+
+void Logger::impl::sweep_loop(){
+    unique_lock<mutex> lock(_writer.mtx);
+    while (!_writer.sweep_stop){
+        int64_t window = _coalesce_ns.load(memory_order_relaxed);
+        _writer.sweep_cv.wait_for(lock, nanoseconds(window > 1000000 ? window : 1000000));
+        if (_writer.sweep_stop){
+            break;
+        }
+        lock.unlock();
+        flush_repeats(true);                                                        ///> written at most two windows late
+        lock.lock();
+    }
+}
+
+void Logger::impl::stop_sweep(){
+    if (!_writer.sweep.joinable()){
+        return;
+    }
+    {
+        lock_guard<mutex> lock(_writer.mtx);
+        _writer.sweep_stop = true;
+    }
+    _writer.sweep_cv.notify_one();
+    _writer.sweep.join();
+    _writer.sweep_stop = false;
+}
+
+void Logger::log_line(unsigned ll, const string& body){
+    (*this)(ll) << body;
+}
+
+void Logger::impl::render_line(string& out, const LogLayout& lay, const LogRecord& rec, LogTime& time){
+    out.clear();
+    lay.render(out, rec, time);
+    out.push_back('\n');
+}
+
+const vector<LogLayout>& Logger::impl::layouts(){
+    struct cache{
+        uint32_t        gen     {0};
+        shared_ptr<const vector<LogLayout>> p;
+    };
+    static thread_local per_logger<cache> tl;
+    cache& c = tl.at(_id);
+    if (!c.p || c.gen != _layout_gen.load(memory_order_acquire)){
+        lock_guard<mutex> lock(_mutex);
+        c.p   = _layouts;
+        c.gen = _layout_gen.load(memory_order_relaxed);
+    }
+    return *c.p;
+}
+
+void Logger::impl::rebuild_layout(){
+    auto lay = make_shared<vector<LogLayout>>();
+    for (unsigned st = args::LOG_COLORS_NONE; st <= STYLE_PLAIN; ++st){
+        if (st == STYLE_JSON){
+            lay->push_back(LogLayout::json_lines());
+            continue;
+        }
+        bool color = st != args::LOG_COLORS_NONE && st != STYLE_PLAIN;
+        string pattern = _pattern;
+        if (pattern.empty()){
+            if (_f_time == args::LOG_STYLE_ON){
+                pattern.append("%T");
+            }
+            if (_f_stat == args::LOG_STYLE_ON){
+                pattern.append(color ? "\033[1;31m[\033[0;0m%^ %L \033[0;0m\033[1;31m]\033[0;0m" : "[%^ %L %$]");
+            }
+            pattern.append(color ? "\033[1;31m‣ \033[0;0m%v" : "‣ %v");
+        }
+        lay->emplace_back(pattern, style_colors(color ? st : static_cast<unsigned>(args::LOG_COLORS_NONE)), color, st == STYLE_PLAIN);
+    }
+    _layouts = lay;
+    _layout_gen.fetch_add(1, memory_order_release);
+    lock_guard<mutex> lock(_write_mutex);
+    update_routes();
+}
+
+void Logger::impl::update_routes(){
+    for (sink_entry& s : _sinks){
+        unsigned format = s.format < args::LOG_FORMAT_INHERIT ? s.format : _f_format;
+        bool term       = s.tty == args::LOG_TTY_AUTO ? s.terminal : s.tty == args::LOG_TTY_ON;
+        s.style = format == args::LOG_FORMAT_JSON ? STYLE_JSON
+                : !term ? STYLE_PLAIN
+                : s.colors <= args::LOG_COLORS_UNDERLINE ? s.colors : _f_color;
+    }
+    for (unsigned l = 0; l < _routes.size(); ++l){
+        uint32_t mask = 0;
+        for (const sink_entry& s : _sinks){
+            if (l <= s.level){
+                mask |= 1u << s.style;
+            }
+        }
+        _routes[l].store(mask, memory_order_release);
+    }
+    publish_crash_sinks();
+}
+
+void Logger::impl::publish_crash_sinks(){
+    auto* next = new vector<crash_sink>();
+    next->reserve(_sinks.size());
+    for (const sink_entry& s : _sinks){
+        next->push_back({s.sink.get(), s.level});
+    }
+    const vector<crash_sink>* old = _crash_sinks.exchange(next);
+    while (_crash_readers.load() != 0){
+        this_thread::yield();                                                       ///> a reader may hold old (a crash never returns)
+    }
+    delete old;
+}
+
+bool Logger::impl::enqueue(const LogRecord& rec){
+    _producers.fetch_add(1);                                                        ///> before the mode check: stop_writer() waits for us
+    unsigned mode = _async.load();
+    if (mode == args::LOG_ASYNC_OFF){
+        _producers.fetch_sub(1);
+        return false;
+    }
+    entry& e = _push_entry;
+    e.body.assign(rec.body.data(), rec.body.size());
+    e.fields.assign(rec.fields.data(), rec.fields.size());
+    e.level  = rec.level;
+    e.time   = rec.time;
+    e.file   = rec.file;
+    e.line   = rec.line;
+    e.thread = rec.thread ? rec.thread : log_thread_id();
+    _pending.fetch_add(1, memory_order_relaxed);
+    while (!_queue->try_push(e)){
+        if (mode == args::LOG_ASYNC_DROP_NEWEST){
+            _dropped.fetch_add(1, memory_order_relaxed);
+            _pending.fetch_sub(1, memory_order_release);
+            break;
+        }
+        if (mode == args::LOG_ASYNC_DROP_OLDEST){
+            if (_queue->try_pop(_drop_entry)){
+                _dropped.fetch_add(1, memory_order_relaxed);
+                _pending.fetch_sub(1, memory_order_release);
+                _drop_entry.body.clear();
+                _drop_entry.fields.clear();
+            }
+            continue;
+        }
+        unique_lock<mutex> lock(_writer.space_mtx);                                 ///> LOG_ASYNC_BLOCK: sleep until the writer frees slots
+        _blocked.fetch_add(1);
+        while (!_queue->try_push(e)){
+            _writer.cv.notify_one();
+            _writer.space_cv.wait_for(lock, milliseconds(10));                      ///> bounded: a missed wake-up costs 10ms at most
+        }
+        _blocked.fetch_sub(1);
+        break;
+    }
+    e.body.clear();                                                                 ///> recycled buffers of the slot
+    e.fields.clear();
+    if (_writer_idle.load()){
+        _writer.cv.notify_one();
+    }
+    _producers.fetch_sub(1);
+    return true;
+}
+
+void Logger::impl::write_sinks(const LogRecord& rec, const vector<LogLayout>& lay, uint32_t rendered){
+    lock_guard<mutex> lock(_write_mutex);
+    for (sink_entry& s : _sinks){
+        if (rec.level > s.level){
+            continue;
+        }
+        string& line = _log_lines[s.style];
+        if (!(rendered >> s.style & 1)){
+            render_line(line, lay[s.style], rec, _time);                           ///> sink changed since routing
+            rendered |= 1u << s.style;
+        }
+        sink_write(*s.sink, line.data(), line.size(), rec.level);
+    }
+}
+
+void Logger::impl::batch_entry(const entry& e, const vector<LogLayout>& lay){
+    LogRecord rec {e.level, e.time, e.file, e.line, e.body, e.thread, e.fields};
+    uint32_t rendered = 0;
+    for (sink_entry& s : _sinks){
+        if (rec.level > s.level){
+            continue;
+        }
+        string& line = _log_lines[s.style];
+        if (!(rendered >> s.style & 1)){
+            render_line(line, lay[s.style], rec, _time);
+            rendered |= 1u << s.style;
+        }
+        if (!s.batched){
+            sink_write(*s.sink, line.data(), line.size(), rec.level);               ///> keeps the level of every line
+            continue;
+        }
+        s.batch.append(line);
+        s.batch_level = min(s.batch_level, rec.level);
+    }
+}
+
+void Logger::impl::write_batches(){
+    for (sink_entry& s : _sinks){
+        if (s.batch.empty()){
+            continue;
+        }
+        sink_write(*s.sink, s.batch.data(), s.batch.size(), s.batch_level);
+        if (s.stream){
+            sink_flush(*s.sink);
+        }
+        s.batch.clear();
+        s.batch_level = args::LOG_DEBUG;
+    }
+}
+
+void Logger::impl::writer_loop(){
+    entry e;
+    bool have = false;
+    for (;;){
+        bool stop = _writer_stop.load(memory_order_acquire);
+        if (have || _queue->try_pop(e)){
+            have = false;
+            const vector<LogLayout>& lay = layouts();
+            lock_guard<mutex> lock(_write_mutex);
+            size_t n = 0;
+            do{
+                batch_entry(e, lay);
+                e.body.clear();
+                e.fields.clear();
+            } while (++n < _queue->capacity() && _queue->try_pop(e));
+            if (_blocked.load() != 0){
+                lock_guard<mutex> space(_writer.space_mtx);
+                _writer.space_cv.notify_all();                                      ///> slots are free while the batch is written
+            }
+            write_batches();
+            _pending.fetch_sub(n, memory_order_release);
+            continue;
+        }
+        if (stop){
+            break;
+        }
+        unique_lock<mutex> lock(_writer.mtx);
+        _writer_idle.store(true);
+        have = _queue->try_pop(e);
+        if (!have){
+            _writer.cv.wait_for(lock, milliseconds(50));
+        }
+        _writer_idle.store(false);
+    }
+}
+
+void Logger::impl::stop_writer(){
+    if (!_writer.th.joinable()){
+        return;
+    }
+    _async.store(args::LOG_ASYNC_OFF);                                              ///> new lines are written on their threads
+    while (_producers.load() != 0){
+        _writer.cv.notify_one();                                                    ///> the writer still frees slots for blocked ones
+        this_thread::yield();
+    }
+    {
+        lock_guard<mutex> lock(_writer.mtx);
+        _writer_stop.store(true, memory_order_release);
+    }
+    _writer.cv.notify_one();
+    _writer.th.join();
+
+    ///> lines a writer stopped mid-batch left behind (none once it drained the queue)
+    entry e;
+    while (_queue->try_pop(e)){
+        const vector<LogLayout>& lay = layouts();
+        write_sinks({e.level, e.time, e.file, e.line, e.body, e.thread, e.fields}, lay, 0);
+        _pending.fetch_sub(1, memory_order_release);
+    }
+}
+
+void Logger::flush(){
+    _impl->flush_repeats();
+    while (_impl->_pending.load(memory_order_acquire) != 0){
+        _impl->_writer.cv.notify_one();
+        this_thread::yield();
+    }
+    if (LogBinary* bin = _bin.load(memory_order_acquire)){
+        bin->flush();
+    }
+    lock_guard<mutex> lock(_impl->_write_mutex);
+    for (impl::sink_entry& s : _impl->_sinks){
+        _impl->sink_flush(*s.sink);
+    }
+}
+
+void Logger::set_log_async(unsigned _mode, size_t _cap){
+    lock_guard<mutex> lock(_impl->_async_mutex);
+    _impl->stop_writer();                                                                  ///> no producer left in the old queue
+    if (_mode == args::LOG_ASYNC_OFF){
+        return;
+    }
+    _impl->_queue.reset(new LogQueue<impl::entry>(_cap));
+    _impl->_writer_stop.store(false);
+    _impl->_writer.th = thread(&impl::writer_loop, _impl.get());
+    _impl->_async.store(_mode);                                                            ///> after the queue: producers find it ready
+}
+
+void Logger::add_snapshot(string n, bool quiet) {
+    {
+        lock_guard<mutex> lock(_impl->_mutex);
+        _impl->_snaps.push_back(LogClock::now());
+        _impl->_snap_ns.push_back(n);
+    }
+    if (LogTrace::enabled()){
+        LogTrace::instant(LogTrace::intern(n));
+    }
+    if (enabled(args::LOG_TIME) && !quiet){
+        log_line(args::LOG_TIME, "Added snap '" + n + "'");
+    }
+}
+
+void Logger::time_since_start() {
+    if (enabled(args::LOG_TIME)) {
+        uint64_t d;
+        {
+            lock_guard<mutex> lock(_impl->_mutex);
+            _impl->_now = LogClock::now();
+            d = LogClock::elapsed(_impl->_start, _impl->_now);
+        }
+        if (LogTrace::enabled()){
+            LogTrace::complete(LogTrace::intern("since start"), _impl->_start, d);
+        }
+        log_line(args::LOG_TIME, to_string(static_cast<double>(d) / 1e9) + "s since instantiation");
+    }
+}
+
+void Logger::time_since_last_snap() {
+    if (enabled(args::LOG_TIME)) {
+        string body;
+        {
+            lock_guard<mutex> lock(_impl->_mutex);
+            if (_impl->_snap_ns.empty()){
+                return;
+            }
+            _impl->_now = LogClock::now();
+            uint64_t d = LogClock::elapsed(_impl->_snaps.back(), _impl->_now);
+            body = to_string(static_cast<double>(d) / 1e9) + "s since last snap '" + _impl->_snap_ns.back() + "'";
+            if (LogTrace::enabled()){
+                LogTrace::complete(LogTrace::intern("since " + _impl->_snap_ns.back()), _impl->_snaps.back(), d);
+            }
+        }
+        log_line(args::LOG_TIME, body);
+    }
+}
+
+void Logger::time_since_snap(string s) {
+    if (enabled(args::LOG_TIME)) {
+        string body;
+        {
+            lock_guard<mutex> lock(_impl->_mutex);
+            _impl->_now = LogClock::now();
+            auto it = std::find(_impl->_snap_ns.begin(), _impl->_snap_ns.end(), s);
+            if (it != _impl->_snap_ns.end()) {
+                unsigned long dist = distance(_impl->_snap_ns.begin(), it);
+                uint64_t d = LogClock::elapsed(_impl->_snaps.at(dist), _impl->_now);
+                body = to_string(static_cast<double>(d) / 1e9) + "s since snap '" + _impl->_snap_ns[dist] + "'";
+                if (LogTrace::enabled()){
+                    LogTrace::complete(LogTrace::intern("since " + s), _impl->_snaps[dist], d);
+                }
+            }
+        }
+        if (body.empty()){
+            log_line(args::LOG_WARN, "Could not find snapshot " + s);
+            return;
+        }
+        log_line(args::LOG_TIME, body);
+    }
+}
+
+void Logger::time_report(unsigned ll) {
+    if (!enabled(ll)) {
+        return;
+    }
+    for (LogTimer* t : LogTimer::all()) {
+        LogHistogram::summary s = t->collect();
+        if (s.count == 0) {
+            continue;
+        }
+        string body = "timer '" + t->name() + "' : n " + to_string(s.count) + ", min ";
+        log_append_ns(body, static_cast<double>(s.min));
+        body += ", mean ";
+        log_append_ns(body, s.mean());
+        body += ", p50 ";
+        log_append_ns(body, static_cast<double>(s.percentile(0.50)));
+        body += ", p99 ";
+        log_append_ns(body, static_cast<double>(s.percentile(0.99)));
+        body += ", max ";
+        log_append_ns(body, static_cast<double>(s.max));
+        log_line(ll, body);
+    }
+}
+
+bool Logger::save_trace(const string& _path, bool _clear) {
+    flush();
+    return LogTrace::save(_path, _clear);
+}
+
+void Logger::set_log_style_time(bool _f){
+    lock_guard<mutex> lock(_impl->_mutex);
+    _impl->_f_time = _f;
+    _impl->rebuild_layout();
+}
+
+void Logger::set_log_style_time_precision(unsigned _p){
+    _impl->_time.set_precision(_p);
+}
+
+void Logger::set_log_style_time_format(unsigned _f){
+    _impl->_time.set_format(_f);
+}
+
+void Logger::set_log_style_status(bool _f){
+    lock_guard<mutex> lock(_impl->_mutex);
+    _impl->_f_stat = _f;
+    _impl->rebuild_layout();
+}
+
+void Logger::set_log_style_colors(unsigned _s){
+    lock_guard<mutex> lock(_impl->_mutex);
+    if (_s <= args::LOG_COLORS_UNDERLINE){
+        _impl->_f_color = _s;
+    }
+    _impl->rebuild_layout();
+}
+
+void Logger::set_log_format(unsigned _f){
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    if (_f < args::LOG_FORMAT_INHERIT){
+        _impl->_f_format = _f;
+    }
+    _impl->update_routes();
+}
+
+array<string, 6> Logger::impl::style_colors(unsigned _s){
+    switch (_s)
+    {
+    case args::LOG_COLORS_NONE:
+        return {
+            "\033[0;0m", /* LOG_ERR */
+            "\033[0;0m", /* LOG_WARN */
+            "\033[0;0m", /* LOG_INFO */
+            "\033[0;0m", /* LOG_TIME */
+            "\033[0;0m", /* LOG_DONE */
+            "\033[0;0m"  /* LOG_DEBUG */
+        };
+
+    case args::LOG_COLORS_REGULAR:
+        return {
+            "\033[0;91m", /* LOG_ERR */
+            "\033[0;93m", /* LOG_WARN */
+            "\033[0;97m", /* LOG_INFO */
+            "\033[0;95m", /* LOG_TIME */
+            "\033[0;92m", /* LOG_DONE */
+            "\033[0;94m"  /* LOG_DEBUG */
+        };
+
+    case args::LOG_COLORS_BOLD:
+        return {
+            "\033[1;31m", /* LOG_ERR */
+            "\033[1;33m", /* LOG_WARN */
+            "\033[1;37m", /* LOG_INFO */
+            "\033[1;35m", /* LOG_TIME */
+            "\033[1;32m", /* LOG_DONE */
+            "\033[1;34m"  /* LOG_DEBUG */
+        };
+
+    case args::LOG_COLORS_BACKGROUND:
+        return {
+            "\033[0;41m", /* LOG_ERR */
+            "\033[0;43m", /* LOG_WARN */
+            "\033[0;47m", /* LOG_INFO */
+            "\033[0;45m", /* LOG_TIME */
+            "\033[0;42m", /* LOG_DONE */
+            "\033[0;44m"  /* LOG_DEBUG */
+        };
+
+    case args::LOG_COLORS_UNDERLINE:
+        return {
+            "\033[4;31m", /* LOG_ERR */
+            "\033[4;33m", /* LOG_WARN */
+            "\033[4;37m", /* LOG_INFO */
+            "\033[4;35m", /* LOG_TIME */
+            "\033[4;32m", /* LOG_DONE */
+            "\033[4;34m"  /* LOG_DEBUG */
+        };
+    }
+    return {};
+}
+
+void Logger::set_log_pattern(string _p){
+    lock_guard<mutex> lock(_impl->_mutex);
+    _impl->_pattern = _p;
+    _impl->rebuild_layout();
+}
+
+void Logger::set_log_file_path(string _path){
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    if (_impl->_file){
+        _impl->detach(_impl->_file);
+        _impl->_file.reset();                                                              ///> writes the rest & closes
+    }
+    _impl->_file_path = _path;
+    if (!_impl->_file_path.empty()){
+        _impl->_file = _impl->_file_compress ? make_shared<CompressedFileSink>(_impl->_file_path, _impl->_file_cfg)
+                               : make_shared<FileSink>(_impl->_file_path, _impl->_file_cfg);
+        _impl->attach(_impl->_file, args::LOG_DEBUG, args::LOG_COLORS_NONE);
+    }
+    _impl->update_routes();
+}
+
+void Logger::set_log_file_flush(size_t _bytes, unsigned _ll, milliseconds _interval){
+    lock_guard<mutex> lock(_impl->_write_mutex);
+    _impl->_file_cfg.flush_bytes    = _bytes;
+    _impl->_file_cfg.flush_level    = _ll;
+    _impl->_file_cfg.flush_interval = _interval;
+    if (_impl->_file){
+        _impl->_file->configure(_impl->_file_cfg);
+    }
+}
+
+void Logger::set_log_file_rotation(size_t _bytes, seconds _interval, unsigned _keep){
+    lock_guard<mutex> lock(_impl->_write_mutex);
+    _impl->_file_cfg.rotate_bytes    = _bytes;
+    _impl->_file_cfg.rotate_interval = _interval;
+    _impl->_file_cfg.max_files       = _keep;
+    if (_impl->_file){
+        _impl->_file->configure(_impl->_file_cfg);
+    }
+}
+
+void Logger::set_log_file_compression(bool _on){
+    string path;
+    {
+        lock_guard<mutex> lock(_impl->_mutex);
+        if (_impl->_file_compress == _on){
+            return;
+        }
+        _impl->_file_compress = _on;
+        path = _impl->_file_path;
+    }
+    set_log_file_path(path);                                                  ///> reopen with the other sink kind
+}
+
+void Logger::set_log_mmap_path(string _path, size_t _segment){
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    if (_impl->_mmap){
+        _impl->detach(_impl->_mmap);
+        _impl->_mmap.reset();                                                              ///> unmaps & truncates
+    }
+    if (!_path.empty()){
+        _impl->_mmap = make_shared<MmapSink>(_path, _segment);
+        _impl->attach(_impl->_mmap, args::LOG_DEBUG, args::LOG_COLORS_NONE);
+    }
+    _impl->update_routes();
+}
+
+void Logger::set_log_shm_name(string _name, size_t _capacity){
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    if (_impl->_shm){
+        _impl->detach(_impl->_shm);
+        _impl->_shm.reset();                                                               ///> unmaps, the segment stays for readers
+    }
+    if (!_name.empty()){
+        _impl->_shm = make_shared<ShmSink>(_name, _capacity);
+        _impl->attach(_impl->_shm, args::LOG_DEBUG, args::LOG_COLORS_NONE);
+    }
+    _impl->update_routes();
+}
+
+void Logger::set_log_socket(string _address){
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    if (_impl->_socket){
+        _impl->detach(_impl->_socket);
+        _impl->_socket.reset();                                                            ///> sends the rest & closes
+    }
+    if (!_address.empty()){
+        _impl->_socket = make_shared<SocketSink>(_address);
+        _impl->attach(_impl->_socket, args::LOG_DEBUG, args::LOG_COLORS_NONE);
+    }
+    _impl->update_routes();
+}
+
+uint64_t Logger::get_log_dropped() const{
+    return _impl->_dropped.load(memory_order_relaxed);
+}
+
+uint64_t Logger::get_log_socket_dropped(){
+    lock_guard<mutex> lock(_impl->_mutex);
+    return _impl->_socket ? _impl->_socket->dropped() : 0;
+}
+
+uint64_t Logger::get_log_file_dropped(){
+    lock_guard<mutex> lock(_impl->_mutex);
+    return _impl->_file ? _impl->_file->dropped() : 0;
+}
+
+void Logger::set_log_binary_path(string _path){
+    lock_guard<mutex> lock(_impl->_write_mutex);
+    _bin.store(nullptr, memory_order_release);
+    _impl->_binary.reset();                                                                ///> writes every thread buffer & closes
+    if (!_path.empty()){
+        _impl->_binary.reset(new LogBinary(_path));
+        _bin.store(_impl->_binary.get(), memory_order_release);
+    }
+}
+
+void Logger::set_log_crash_handlers(bool _on, bool _terminate){
+    if (_on){
+        LogCrash::install([](void* ctx){ static_cast<Logger*>(ctx)->emergency_flush(); }, this, _terminate);
+    }
+    else if (LogCrash::installed(this)){
+        LogCrash::uninstall();
+    }
+}
+
+void Logger::emergency_flush(){
+    static constexpr const char* names[] {"ERROR", "WARNING", "INFO", "TIME", "DONE", "DEBUG"};
+    _impl->_crash_readers.fetch_add(1);                                                    ///> before the load: the list stays alive
+    const vector<impl::crash_sink>* sinks = _impl->_crash_sinks.load();
+    if (sinks){
+        for (const impl::crash_sink& s : *sinks){
+            s.sink->emergency_flush();                                                     ///> buffered lines are older than queued ones
+        }
+    }
+    LogQueue<impl::entry>* q = _impl->_queue.get();
+    while (q && q->try_pop(_impl->_crash_entry)){                                          ///> swap: no allocation, no free
+        const impl::entry& e = _impl->_crash_entry;
+        int64_t ms = duration_cast<milliseconds>(e.time.time_since_epoch()).count();
+        LogEmergency out(false);
+        out << ms / 1000 << '.' << static_cast<char>('0' + ms % 1000 / 100) << static_cast<char>('0' + ms % 100 / 10)
+            << static_cast<char>('0' + ms % 10) << " [" << (e.level < 6 ? names[e.level] : "?") << "] ";
+        out.append(e.body.data(), e.body.size());
+        string_view line = out.line();
+        bool raw = !sinks || sinks->empty();
+        for (size_t i = 0; sinks && i < sinks->size(); ++i){
+            const impl::crash_sink& s = (*sinks)[i];
+            if (e.level <= s.level && !s.sink->emergency_write(line.data(), line.size())){
+                raw = true;                                                                ///> once for all sinks without a crash path
+            }
+        }
+        if (raw){
+            LogEmergency::write_all(line.data(), line.size());
+        }
+        _impl->_pending.fetch_sub(1, memory_order_release);                                ///> flush() after a direct call must not wait for it
+    }
+    _impl->_crash_readers.fetch_sub(1);
+}
+
+void Logger::set_log_trace(bool _on, size_t _limit){
+    LogTrace::set_enabled(_on, _limit);
+}
+
+bool Logger::set_log_clock(unsigned _src){
+    return LogClock::set_source(_src == args::LOG_CLOCK_TSC ? LogClock::TSC : LogClock::STEADY);
+}
+
+void Logger::set_log_coalesce(milliseconds _window){
+    _impl->_coalesce_ns.store(duration_cast<nanoseconds>(_window).count(), memory_order_relaxed);
+    if (_window <= milliseconds(0)){
+        _impl->_coalesce_ns.store(0, memory_order_relaxed);
+        _impl->stop_sweep();
+        _impl->flush_repeats();
+        return;
+    }
+    lock_guard<mutex> lock(_impl->_mutex);
+    if (!_impl->_writer.sweep.joinable()){
+        _impl->_writer.sweep = thread(&impl::sweep_loop, _impl.get());
+    }
+}
+
+shared_ptr<LogSink> Logger::add_sink(shared_ptr<LogSink> _sink, unsigned _ll, unsigned _colors){
+    share(*_sink);
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    _impl->attach(_sink, _ll, _colors);
+    _impl->update_routes();
+    return _sink;
+}
+
+shared_ptr<LogSink> Logger::add_sink(ostream& f, unsigned _ll, unsigned _colors){
+    shared_ptr<LogSink> sink = stream_sink(f);
+    share(*sink);
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    for (const impl::sink_entry& s : _impl->_sinks){
+        if (s.sink == sink){
+            return s.sink;
+        }
+    }
+    _impl->attach(sink, _ll, _colors);
+    _impl->update_routes();
+    return sink;
+}
+
+void Logger::remove_sink(const shared_ptr<LogSink>& _sink){
+    {
+        lock_guard<mutex> lock(_impl->_mutex);
+        lock_guard<mutex> wlock(_impl->_write_mutex);
+        _impl->detach(_sink);
+        _impl->update_routes();
+    }
+    lock_guard<mutex> lock(share_mutex());                                         ///> after detach: no unlocked write left
+    if (_sink->_owner == this){
+        _sink->_owner = nullptr;
+    }
+}
+
+void Logger::set_sink_level(const shared_ptr<LogSink>& _sink, unsigned _ll){
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    for (impl::sink_entry& s : _impl->_sinks){
+        if (s.sink == _sink){
+            s.level = _ll;
+        }
+    }
+    _impl->update_routes();
+}
+
+void Logger::set_sink_colors(const shared_ptr<LogSink>& _sink, unsigned _colors){
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    for (impl::sink_entry& s : _impl->_sinks){
+        if (s.sink == _sink){
+            s.colors = _colors;
+        }
+    }
+    _impl->update_routes();
+}
+
+void Logger::set_sink_format(const shared_ptr<LogSink>& _sink, unsigned _format){
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    for (impl::sink_entry& s : _impl->_sinks){
+        if (s.sink == _sink){
+            s.format = _format;
+        }
+    }
+    _impl->update_routes();
+}
+
+void Logger::set_sink_tty(const shared_ptr<LogSink>& _sink, unsigned _tty){
+    lock_guard<mutex> lock(_impl->_mutex);
+    lock_guard<mutex> wlock(_impl->_write_mutex);
+    for (impl::sink_entry& s : _impl->_sinks){
+        if (s.sink == _sink){
+            s.tty = _tty;
+        }
+    }
+    _impl->update_routes();
+}
+
+void Logger::impl::attach(const shared_ptr<LogSink>& _sink, unsigned _ll, unsigned _colors){
+    if (!_sink->_owner){
+        _sink->_owner = &self;                                                      ///> own new sink, not seen by another Logger yet
+    }
+    bool stream = dynamic_cast<OstreamSink*>(_sink.get()) != nullptr;
+    _sinks.push_back({_sink, _ll, _colors, args::LOG_FORMAT_INHERIT, args::LOG_TTY_AUTO, _sink->is_tty(), 0, stream, _sink->batched(), {}, args::LOG_DEBUG});
+}
+
+void Logger::impl::detach(const shared_ptr<LogSink>& _sink){
+    _sinks.erase(remove_if(_sinks.begin(), _sinks.end(), [&](const sink_entry& s){ return s.sink == _sink; }), _sinks.end());
+}
+
+}
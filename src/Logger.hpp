@@ -1,18 +1,18 @@
 #pragma once
 
-#include <algorithm>
-#include <array>
-#include <ctime>
-#include <iomanip>
-#include <iostream>
-#include <mutex>
-#include <thread>
-#include <string>
-#include <sstream>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
 
-using namespace std;
-using namespace chrono;
+#include <LogArgs.hpp>
+#include <LogCategory.hpp>
+#include <LogFormat.hpp>
+#include <LogKV.hpp>
+#include <LogLimit.hpp>
+#include <LogSite.hpp>
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //  GLOBAL                                                                                                          //
@@ -20,365 +20,288 @@ using namespace chrono;
 namespace cpp_up{
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//  INTERFACE ARGS                                                                                                  //
+//  LOGGER                                                                                                          //
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-namespace args{
 /*
-*   Enable/Disable time/status/call_location part in log line
+*   Shorthand for the constructor call (direct all logs to specific stream)
 */
-enum l_action{
-    LOG_STYLE_OFF           = 0,
-    LOG_STYLE_ON            = 1
-};
+#define LOG_INIT_COUT()     Logger& log = Logger::get_instance(std::cout)
+#define LOG_INIT_CERR()     Logger& log = Logger::get_instance(std::cerr)
+#define LOG_INIT_CLOG()     Logger& log = Logger::get_instance(std::clog)
+#define LOG_INIT_CUSTOM(X)  Logger& log = Logger::get_instance((X))
 
 /*
-*   Log level to set and call
+*   Same for a named instance: own locks, level & style, created on first use (stream X), lock-free lookup afterwards
 */
-enum l_level{
-    LOG_SILENT              = -1,       ///> SYSTEM DO NOT USE
-    LOG_ERR                 = 0,
-    LOG_WARN                = 1,
-    LOG_INFO                = 2,
-    LOG_TIME                = 3,
-    LOG_DONE                = 4,
-    LOG_DEBUG               = 5,        ///> DEBUG
-    LOG_DEFAULT             = 4         ///> without DEBUG
-};
+#define LOG_INIT_NAMED(N, X) Logger& log = Logger::get((N), (X))
 
 /*
-*   Log color style settings
+*   Compile-time level limit: LOG_MSG statements above it are discarded with their arguments
+*   (pass -DCPP_UP_LOG_COMPILE_LEVEL=N, 0 = LOG_ERR ... 5 = LOG_DEBUG)
 */
-enum l_style{
-    LOG_COLORS_NONE         = 0,
-    LOG_COLORS_REGULAR      = 1,
-    LOG_COLORS_BOLD         = 2,
-    LOG_COLORS_BACKGROUND   = 3,
-    LOG_COLORS_UNDERLINE    = 4
-};
-}
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//  LOGGER                                                                                                          //
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef CPP_UP_LOG_COMPILE_LEVEL
+#define CPP_UP_LOG_COMPILE_LEVEL    5
+#endif
+
 /*
-*   Shorthand for the constructor call (direct all logs to specific stream)
+*   Shorthand for the log statement with compile-time stripping: LOG_MSG(LOG_DEBUG) << ...
+*   - runtime-disabled levels skip the << operands entirely (one relaxed load + branch)
+*   - the level is the one of logger X (default instance: the default level)
+*   - every statement owns a static LogSite (file, line & binary descriptor)
 */
-#define LOG_INIT_COUT()     Logger& log = Logger::get_instance(cout)
-#define LOG_INIT_CERR()     Logger& log = Logger::get_instance(cerr)
-#define LOG_INIT_CLOG()     Logger& log = Logger::get_instance(clog)
-#define LOG_INIT_CUSTOM(X)  Logger& log = Logger::get_instance((X))
+#define LOG_MSG(L)          LOG_MSG_TO(log, L)
+#define LOG_MSG_TO(X, L)    if constexpr (!cpp_up::Logger::compiled_in((L))) {} \
+                            else if (!(X).enabled((L))) {} else (X)((L), LOG_SITE())
+#define LOG_SITE()          []() -> cpp_up::LogSite& { static cpp_up::LogSite _site {__FILE__, __LINE__}; return _site; }()
+
+/*
+*   Same, filtered by the level of a LogCategory instead of the default level: LOG_CAT(net_log, LOG_DEBUG) << ...
+*/
+#define LOG_CAT(C, L)       LOG_CAT_TO(log, C, L)
+#define LOG_CAT_TO(X, C, L) if constexpr (!cpp_up::Logger::compiled_in((L))) {} \
+                            else if (!(C).enabled((L))) {} else (X)((C), (L), LOG_SITE())
+
+/*
+*   Limited log statements: the check runs before any << operand, the suppressed count is appended to the next line
+*   - LOG_EVERY_N(L, N)     1st, (N+1)th, ... call
+*   - LOG_FIRST_N(L, N)     first N calls
+*   - LOG_RATE(L, K)        at most K lines per second (bursts of up to K, K < 1: one line every 1/K s)
+*/
+#define LOG_EVERY_N(L, N)   LOG_LIMIT_TO(log, L, cpp_up::log_every_n(_site, (N)))
+#define LOG_FIRST_N(L, N)   LOG_LIMIT_TO(log, L, cpp_up::log_first_n(_site, (N)))
+#define LOG_RATE(L, K)      LOG_LIMIT_TO(log, L, cpp_up::log_rate(_site, (K)))
+#define LOG_LIMIT_TO(X, L, C)   if constexpr (!cpp_up::Logger::compiled_in((L))) {} \
+                                else if (!(X).enabled((L))) {} \
+                                else if (cpp_up::LogSite& _site = LOG_SITE(); !(C)) {} \
+                                else (X)((L), _site, _site.skipped.exchange(0, std::memory_order_relaxed))
+
+class LogBinary;                                                                    ///> modules behind Logger: include their headers to use them directly
+struct LogRecord;
+class LogSink;
 
 class Logger {
 public:
     /*
     *   Construct
     */
-    inline              Logger                  (ostream&, unsigned);           ///> Non-default log level
-    inline              Logger                  (ostream&);                     ///> Default log level      : LOG_INIT_..()
+                        Logger                  (std::ostream&, unsigned);      ///> Non-default log level
+                        Logger                  (std::ostream&);                ///> Default log level      : LOG_INIT_..()
     inline              Logger                  ()                  = delete;
     inline              Logger                  (Logger& _src)      = delete;   ///> Copy semantics
     inline              Logger& operator=       (Logger const&)     = delete;
     inline              Logger                  (Logger&& _src)     = delete;   ///> Move semantics
     inline              Logger& operator=       (Logger const&&)    = delete;
-    static Logger&      get_instance            (ostream& f) {
-        static Logger _instance(f);
-        return _instance;
-    }
+                        ~Logger                 ();                             ///> Drain async queue & stop writer
+    static Logger&      get_instance            (std::ostream&);                ///> Process-wide logger on the stream of the first call
+    static Logger&      get                     (const std::string&, std::ostream&); ///> Named instance, created with the stream on first use ("" = get_instance)
+    static Logger*      find                    (const std::string&);           ///> Named instance or nullptr (lock-free)
+    inline const std::string& name              () const { return _name; }      ///> "" for the default instance
     
     /*
     *   OVERLOADED OPERATOR: I + O + log assembly
     *   - assemble & release msg from thread-specific container
     */
     struct expr{
-        expr (string& _msg, ostream& _fac) : msg(_msg), fac(_fac){
-            if(msg.find("_no_log_") != string::npos){
-                f_blocked = true;
+        expr (std::string& _msg, Logger& _log, bool _blocked, unsigned _ll, const char* _file, unsigned _line, LogBinaryRecord* _bin = nullptr, uint64_t _skipped = 0)
+            : f_blocked(_blocked), msg(_msg), log(_log), level(_ll), file(_file), line(_line), bin(_bin), skipped(_skipped){
+            if (!f_blocked && !bin){
+                time = std::chrono::system_clock::now();
             }
         };
 
         ~expr (){
-            if (!f_blocked){
-                msg.append("\n");
-                fac << msg;
+            if (skipped != 0 && !f_blocked){
+                *this << " (" << skipped << " suppressed)";
+            }
+            if (bin){
+                bin->end();
+            }
+            else if (!f_blocked){
+                log.commit(*this);
             }
             msg.clear();
+            _log_fields.clear();
         }
 
         template <class T>
         expr& operator<<(const T& s) {
-            if (!f_blocked){
-                stringstream ss;
-                ss << s;
-                msg.append(ss.str());
+            if (bin){
+                bin->append(s);
+            }
+            else if (!f_blocked){
+                log_append(msg, s);
+            }
+            return *this;
+        }
+
+        template <size_t N>
+        expr& operator<<(const char (&s)[N]) {                                     ///> literal: stored once per call site in binary mode
+            if (bin){
+                bin->append_literal(s, N);
+            }
+            else if (!f_blocked){
+                log_append(msg, s);
+            }
+            return *this;
+        }
+
+        template <size_t N>
+        expr& operator<<(char (&s)[N]) {                                           ///> mutable buffer: never a literal
+            return *this << static_cast<const char*>(s);
+        }
+
+        template <class T>
+        expr& operator<<(const LogKV<T>& kv) {                                     ///> typed field (text in binary mode)
+            if (bin){
+                bin->append(kv);
+            }
+            else if (!f_blocked){
+                LogFields::add(_log_fields, kv.key, kv.value);
             }
             return *this;
         }
 
         bool        f_blocked {false};
-        ostream&    fac;
-        string&     msg;
+        std::string& msg;
+        Logger&     log;
+        unsigned    level;
+        const char* file;
+        unsigned    line;
+        std::chrono::system_clock::time_point time;
+        LogBinaryRecord* bin;
+        uint64_t    skipped;
     };
-    inline expr         operator()              (unsigned ll);                  ///> push head into thread-specific container into ostream
+    inline expr         operator()              (unsigned ll, const char* file = nullptr, unsigned line = 0); ///> push msg into thread-specific container, render on release
+    inline expr         operator()              (unsigned ll, LogSite&, uint64_t skipped = 0); ///> Same, from a LOG_MSG call site (binary mode aware)
+    inline expr         operator()              (const LogCategory&, unsigned ll, const char* file = nullptr, unsigned line = 0); ///> Filtered by the category level
+    inline expr         operator()              (const LogCategory&, unsigned ll, LogSite&); ///> Same, from a LOG_CAT call site
+    void                log_record              (const LogRecord&);             ///> Render & write an externally built record (decoders, bridges)
+    static constexpr bool compiled_in           (unsigned ll) { return ll <= CPP_UP_LOG_COMPILE_LEVEL; } ///> Level survives compile-time limit
+    static bool         is_enabled              (unsigned ll) {                 ///> Level passes compile-time & default runtime limit
+        return compiled_in(ll) && ll <= _loglevel().load(std::memory_order_relaxed);
+    }
+    inline bool         enabled                 (unsigned ll) const {           ///> Same, with the level of this instance
+        return compiled_in(ll) && ll <= _level->load(std::memory_order_relaxed);
+    }
 
     /*
     *   TIME SNAP
     */
-    inline void         add_snapshot            (string n, bool quiet = false); ///> Add named time snapshot
-    inline void         time_since_start        ();                             ///> Log the time since the log was initialized (better to init log obj right at the beginning)
-    inline void         time_since_last_snap    ();                             ///> Log the time since the last time snapshot
-    inline void         time_since_snap         (string);                       ///> Log the time since the last named time snapshot
+    void                add_snapshot            (std::string n, bool quiet = false); ///> Add named time snapshot
+    void                time_since_start        ();                             ///> Log the time since the log was initialized (better to init log obj right at the beginning)
+    void                time_since_last_snap    ();                             ///> Log the time since the last time snapshot
+    void                time_since_snap         (std::string);                  ///> Log the time since the last named time snapshot
+    void                time_report             (unsigned ll = args::LOG_TIME); ///> Log count/min/mean/p50/p99/max of every ScopedTimer name
+    bool                save_trace              (const std::string&, bool clear = false); ///> Write recorded spans & snapshots as Chrome trace JSON (clear: drop the saved ones)
     
     /*
     *   SYSTEM SETUP
     */
-    inline void         set_log_level           (unsigned ll) { _loglevel() = ll; } ///>Set logging level
-    inline void         set_log_style_time      (bool);                         ///> Enable/Disable time module in logging
-    inline void         set_log_style_status    (bool);                         ///> Enable/Disable status module in logging
-    inline void         set_log_style_colors    (unsigned);                     ///> Set color style of logs
-    inline void         set_log_file_path       (string);                       ///> Set PATH to log file 
+    void                set_log_level           (unsigned ll);                  ///> Set logging level (default instance: categories without an own level follow)
+    inline void         set_log_level           (const std::string& c, unsigned ll) { LogCategory::set_level(c, ll); } ///> Set level of a category
+    inline bool         set_log_levels          (const std::string& spec) { return LogCategory::configure(spec); } ///> "net=debug,db=warn,info" (like CPP_UP_LOG)
+    void                set_log_style_time      (bool);                         ///> Enable/Disable time module in logging
+    void                set_log_style_time_precision (unsigned);                ///> Set sub-second digits of time module
+    void                set_log_style_time_format (unsigned);                   ///> Set layout & zone of time module
+    void                set_log_style_status    (bool);                         ///> Enable/Disable status module in logging
+    void                set_log_style_colors    (unsigned);                     ///> Set color style of logs
+    void                set_log_format          (unsigned);                     ///> args::l_format of sinks without an own format (LOG_FORMAT_JSON = JSON Lines)
+    void                set_log_pattern         (std::string);                  ///> Set line pattern, e.g. "%Y-%m-%d %H:%M:%S.%f [%L] %t %v" ("" = set_log_style_* modules)
+    void                set_log_file_path       (std::string);                  ///> Also write to buffered log file ("" = close it)
+    void                set_log_file_flush      (size_t, unsigned, std::chrono::milliseconds); ///> Flush file at N bytes, at level (and more severe), every interval
+    void                set_log_file_rotation   (size_t, std::chrono::seconds, unsigned); ///> Rotate file at N bytes and/or interval, keep N files
+    void                set_log_file_compression (bool);                        ///> Compress rotated files in the background ('log.txt.1.cpz', cpp_up_logz)
+    void                set_log_mmap_path       (std::string, size_t segment = 64 << 20); ///> Also write to memory-mapped log file ("" = close it)
+    void                set_log_shm_name        (std::string, size_t capacity = 4 << 20); ///> Also publish lines into a shared-memory ring for cpp_up_tail ("" = detach)
+    void                set_log_socket          (std::string);                  ///> Also send lines to a collector: "unix:/path", "unixgram:/path", "udp:host:port", "tcp:host:port" ("" = close)
+    void                set_log_binary_path     (std::string);                  ///> Record lines as binary stream instead of text ("" = back to text; set before logging threads start)
+    void                set_log_async           (unsigned, size_t cap = 8192);  ///> Enable/Disable background writer (safe while threads log: waits for them to leave the queue)
+    void                set_log_trace           (bool, size_t limit = 1 << 20); ///> Record snapshots, ScopedTimer & LOG_TRACE_SCOPE spans (limit = events per thread)
+    bool                set_log_clock           (unsigned);                     ///> Clock of snapshots, timers, traces & LOG_RATE (false = TSC unusable, steady kept)
+    void                set_log_coalesce        (std::chrono::milliseconds);    ///> Fold identical consecutive lines of a thread within window into "last message repeated N times" (0 = off)
+
+    /*
+    *   SINKS: each line is rendered once per distinct color style, then handed to every sink whose level allows it
+    */
+    std::shared_ptr<LogSink> add_sink           (std::shared_ptr<LogSink>, unsigned ll = args::LOG_DEBUG, unsigned colors = args::LOG_COLORS_INHERIT);
+    std::shared_ptr<LogSink> add_sink           (std::ostream&, unsigned ll = args::LOG_DEBUG, unsigned colors = args::LOG_COLORS_INHERIT); ///> Once per stream
+    void                remove_sink             (const std::shared_ptr<LogSink>&);
+    void                set_sink_level          (const std::shared_ptr<LogSink>&, unsigned); ///> Most verbose level the sink gets
+    void                set_sink_colors         (const std::shared_ptr<LogSink>&, unsigned); ///> args::l_style of the sink
+    void                set_sink_format         (const std::shared_ptr<LogSink>&, unsigned); ///> args::l_format of the sink
+    void                set_sink_tty            (const std::shared_ptr<LogSink>&, unsigned); ///> args::l_tty of the sink (piped output is plain by default)
+    uint64_t            get_log_dropped         () const;                       ///> Lines lost by DROP_* policies
+    uint64_t            get_log_socket_dropped  ();                             ///> Lines the set_log_socket collector did not take in time
+    uint64_t            get_log_file_dropped    ();                             ///> Lines the set_log_file_path file could not take (not open, write error)
+    void                flush                   ();                             ///> Write pending repeat summaries, wait for queued lines & flush every output
+
+    /*
+    *   CRASH: async-signal-safe, best effort (nothing that is locked by the dying process is touched)
+    */
+    void                set_log_crash_handlers  (bool, bool terminate = false); ///> Report fatal signals & emergency_flush() before dying (terminate: SIGTERM/SIGINT too)
+    void                emergency_flush         ();                             ///> write(2) sink buffers, then queued async lines through the sinks' crash path (else LogEmergency's fd)
 
 private:
     /*
     *   SYSTEM
     */
-    inline void         flush                   () { _fac.flush(); }            ///> Flush stream
-    inline string       prep_level              ();                             ///> Set logging level
-    inline string       prep_time               ();                             ///> Set logging time
-    static unsigned&    _loglevel               ()                              ///> Get log level
+    struct impl;                                                                ///> sinks, layouts, outputs, async writer & time snaps (Logger.cpp only)
+    struct registry;
+    static registry&    reg                     ();                             ///> Named instances (never removed)
+    void                share                   (LogSink&);                     ///> Lock a sink that another Logger writes too (before own locks)
+    void                commit                  (const expr&);                  ///> Hand a finished text statement over (coalesce, render & write)
+    LogBinaryRecord*    begin_binary            (LogBinary&, LogSite&, unsigned); ///> Open the record of a statement in binary mode
+    LogBinaryRecord*    begin_binary            (LogBinary&, const char*, unsigned, unsigned); ///> Same, site of an explicit file & line (none: no site)
+    void                log_line                (unsigned, const std::string&); ///> Commit internal msg (time snaps)
+    static std::atomic<unsigned>& _loglevel     ()                              ///> Get log level (read lock-free on every call)
     {
-        static unsigned _ll_internal = args::LOG_DEFAULT;
-        return _ll_internal;
+        return LogCategory::default_level();
     };
 
-    time_t              _clock_now;
-    high_resolution_clock::time_point          _now;
-    high_resolution_clock::time_point          _start;
-    vector<high_resolution_clock::time_point>  _snaps;
-    vector<string>      _snap_ns;
-    unsigned            _message_level;
-    ostream&            _fac;
-    string              _file_path              {""};       //IN_PROGRESS
-    bool                _f_time                 {false};
-    bool                _f_stat                 {false};
-    unsigned            _f_color                {0};
-    array<string, 6>    _color;
-    mutex               _mutex;
-    inline static thread_local string _log_msg;
+    static constexpr size_t NAMED_SLOTS         = 256;                          ///> initial registry slots (doubled at 3/4 use)
+    std::unique_ptr<impl> _impl;
+    std::string         _name                   {""};
+    std::atomic<unsigned> _own_level            {args::LOG_DEFAULT};            ///> level of a named instance
+    std::atomic<unsigned>* _level               {&_loglevel()};                 ///> default instance: LogCategory default level
+    std::atomic<LogBinary*> _bin                {nullptr};                      ///> read on every LOG_MSG
+    inline static thread_local std::string _log_msg;
+    inline static thread_local std::string _log_fields;                         ///> log_kv fields of the statement
 };
 
 
 
-Logger::Logger(ostream& f, unsigned ll)
-    : _message_level(args::LOG_SILENT), _fac(f)
-{
-    _now = high_resolution_clock::now();
-    _start = high_resolution_clock::now();
-    _loglevel() = ll;
-    set_log_style_colors(args::LOG_COLORS_NONE);
-}
-
-Logger::Logger(ostream& f)
-    : _message_level(args::LOG_SILENT), _fac(f)
-{
-    _now = high_resolution_clock::now();
-    _start = high_resolution_clock::now();
-    set_log_style_colors(args::LOG_COLORS_NONE);
-}
-
-Logger::expr Logger::operator()(unsigned ll){
-    lock_guard<mutex> lock(_mutex);
-    _message_level = ll;
-    if (_message_level <= _loglevel()){
-        if (_f_color != args::LOG_COLORS_NONE){
-            _log_msg.append(prep_time() + prep_level() + "\033[1;31m‣ \033[0;0m");
-        }
-        else
-            _log_msg.append(prep_time() + prep_level() + "‣ ");   
-    }
-    else
-        _log_msg.append("_no_log_");
-    
-    return {_log_msg, _fac};
-}
-
-string Logger::prep_level() {
-    if(_f_stat == args::LOG_STYLE_ON){
-        if (_f_color != args::LOG_COLORS_NONE){
-            switch (_message_level){
-            case args::LOG_ERR:   return string("\033[1;31m[\033[0;0m" + _color.at(args::LOG_ERR)  +  " ERROR   " + "\033[0;0m\033[1;31m]\033[0;0m"); break;
-            case args::LOG_WARN:  return string("\033[1;31m[\033[0;0m" + _color.at(args::LOG_WARN) +  " WARNING " + "\033[0;0m\033[1;31m]\033[0;0m"); break;
-            case args::LOG_INFO:  return string("\033[1;31m[\033[0;0m" + _color.at(args::LOG_INFO) +  " INFO    " + "\033[0;0m\033[1;31m]\033[0;0m"); break;
-            case args::LOG_DEBUG: return string("\033[1;31m[\033[0;0m" + _color.at(args::LOG_DEBUG) + " DEBUG   " + "\033[0;0m\033[1;31m]\033[0;0m"); break;
-            case args::LOG_TIME:  return string("\033[1;31m[\033[0;0m" + _color.at(args::LOG_TIME) +  " TIME    " + "\033[0;0m\033[1;31m]\033[0;0m"); break;
-            case args::LOG_DONE:  return string("\033[1;31m[\033[0;0m" + _color.at(args::LOG_DONE) +  " DONE    " + "\033[0;0m\033[1;31m]\033[0;0m"); break;
-            }
-        }
-        else{
-            switch (_message_level){
-            case args::LOG_ERR:   return string("[" + _color.at(args::LOG_ERR)  +  " ERROR   " + "\033[0;0m]"); break;
-            case args::LOG_WARN:  return string("[" + _color.at(args::LOG_WARN) +  " WARNING " + "\033[0;0m]"); break;
-            case args::LOG_INFO:  return string("[" + _color.at(args::LOG_INFO) +  " INFO    " + "\033[0;0m]"); break;
-            case args::LOG_DEBUG: return string("[" + _color.at(args::LOG_DEBUG) + " DEBUG   " + "\033[0;0m]"); break;
-            case args::LOG_TIME:  return string("[" + _color.at(args::LOG_TIME) +  " TIME    " + "\033[0;0m]"); break;
-            case args::LOG_DONE:  return string("[" + _color.at(args::LOG_DONE) +  " DONE    " + "\033[0;0m]"); break;
-            }
-        }
+Logger::expr Logger::operator()(unsigned ll, const char* file, unsigned line){
+    LogBinary* bin = _bin.load(std::memory_order_acquire);
+    if (bin && enabled(ll)){
+        return {_log_msg, *this, false, ll, file, line, begin_binary(*bin, file, line, ll)};
     }
-    return "";
+    return {_log_msg, *this, !enabled(ll), ll, file, line};
 }
 
-string Logger::prep_time() {
-    string ret{""};
-    if(_f_time == args::LOG_STYLE_ON){
-        time(&_clock_now);
-        struct tm* t;
-        t = localtime(&_clock_now);
-        string s, m, h, D, M, Y;
-        s = to_string(t->tm_sec);
-        m = to_string(t->tm_min);
-        h = to_string(t->tm_hour);
-        D = to_string(t->tm_mday);
-        M = to_string(t->tm_mon + 1);
-        Y = to_string(t->tm_year + 1900);
-
-        if (t->tm_sec < 10) s = "0" + s;
-        if (t->tm_min < 10) m = "0" + m;
-        if (t->tm_hour < 10) h = "0" + h;
-        if (t->tm_mday < 10) D = "0" + D;
-        if (t->tm_mon + 1 < 10) M = "0" + M;
-
-        if (_f_color != args::LOG_COLORS_NONE){
-            ret.append("\033[1;31m[\033[0;0m \033[0;34mD \033[0;96m" + Y + "-" + M + "-" + D + "; \033[0;34mT \033[0;96m" + h + ":" + m + ":" + s + " \033[1;31m]\033[0;0m");
-        }
-        else{
-            ret.append("[ D " + D + "." + M + "." + Y + "; T " + h + ":" + m + ":" + s + " ]");    
-        }    
+Logger::expr Logger::operator()(unsigned ll, LogSite& site, uint64_t skipped){
+    LogBinary* bin = _bin.load(std::memory_order_acquire);
+    if (bin && enabled(ll)){
+        return {_log_msg, *this, false, ll, site.file, site.line, begin_binary(*bin, site, ll), skipped};
     }
-    return ret;
-}
-
-void Logger::add_snapshot(string n, bool quiet) {
-    lock_guard<mutex> lock(_mutex);
-    _snaps.push_back(high_resolution_clock::now());
-    _snap_ns.push_back(n);
-    if (_loglevel() >= args::LOG_TIME && !quiet)
-        _message_level = args::LOG_TIME;
-        _fac << prep_time() + prep_level() + "\033[1;31m‣\033[0;0m Added snap '" + n + "'\n";
+    return {_log_msg, *this, !enabled(ll), ll, site.file, site.line, nullptr, skipped};
 }
 
-void Logger::time_since_start() {
-    lock_guard<mutex> lock(_mutex);
-    if (_loglevel() >= args::LOG_TIME) {
-        _now = high_resolution_clock::now();    
-        _message_level = args::LOG_TIME;
-        duration<double> t = duration_cast<duration<double>>(_now - _start);
-        _fac << prep_time() + prep_level() + "\033[1;31m‣ \033[0;0m" + to_string(t.count()) + "s since instantiation\n";
+Logger::expr Logger::operator()(const LogCategory& cat, unsigned ll, const char* file, unsigned line){
+    bool on = compiled_in(ll) && cat.enabled(ll);
+    LogBinary* bin = _bin.load(std::memory_order_acquire);
+    if (bin && on){
+        return {_log_msg, *this, false, ll, file, line, begin_binary(*bin, file, line, ll)};
     }
+    return {_log_msg, *this, !on, ll, file, line};
 }
 
-void Logger::time_since_last_snap() {
-    lock_guard<mutex> lock(_mutex);
-    if (_loglevel() >= args::LOG_TIME && _snap_ns.size() > 0) {
-        _now = high_resolution_clock::now();
-        _message_level = args::LOG_TIME;
-        duration<double> t = duration_cast<duration<double>>(_now - _snaps.back());
-        _fac << prep_time() + prep_level() + "\033[1;31m‣ \033[0;0m" + to_string(t.count()) + "s since last snap '" + _snap_ns.back() + "'\n";
+Logger::expr Logger::operator()(const LogCategory& cat, unsigned ll, LogSite& site){
+    bool on = compiled_in(ll) && cat.enabled(ll);
+    LogBinary* bin = _bin.load(std::memory_order_acquire);
+    if (bin && on){
+        return {_log_msg, *this, false, ll, site.file, site.line, begin_binary(*bin, site, ll)};
     }
+    return {_log_msg, *this, !on, ll, site.file, site.line};
 }
 
-void Logger::time_since_snap(string s) {
-    lock_guard<mutex> lock(_mutex);
-    if (_loglevel() >= args::LOG_TIME) {
-        _now = high_resolution_clock::now();
-        auto it = find(_snap_ns.begin(), _snap_ns.end(), s);
-        if (it == _snap_ns.end()) {
-            _message_level = args::LOG_WARN;
-            _fac << prep_time() + prep_level() + "‣ " + "Could not find snapshot " + s + '\n';
-            return;
-        }
-        unsigned long dist = distance(_snap_ns.begin(), it);
-        _message_level = args::LOG_TIME;
-        duration<double> t = duration_cast<duration<double>>(_now - _snaps.at(dist));
-        _fac << prep_time() + prep_level() + "\033[1;31m‣ \033[0;0m" + to_string(t.count()) + "s since snap '" + _snap_ns[dist] + "'\n";
-    }
 }
-
-void Logger::set_log_style_time(bool _f){
-    _f_time = _f;
-}
-
-void Logger::set_log_style_status(bool _f){
-    _f_stat = _f;
-}
-
-void Logger::set_log_style_colors(unsigned _s){
-    switch (_s)
-    {
-    case args::LOG_COLORS_NONE:
-        _color = {
-            "\033[0;0m", /* LOG_ERR */
-            "\033[0;0m", /* LOG_WARN */
-            "\033[0;0m", /* LOG_INFO */
-            "\033[0;0m", /* LOG_TIME */
-            "\033[0;0m", /* LOG_DONE */
-            "\033[0;0m"  /* LOG_DEBUG */
-        };
-        _f_color = _s;
-        break;
-
-    case args::LOG_COLORS_REGULAR:
-        _color = {
-            "\033[0;91m", /* LOG_ERR */
-            "\033[0;93m", /* LOG_WARN */
-            "\033[0;97m", /* LOG_INFO */
-            "\033[0;95m", /* LOG_TIME */
-            "\033[0;92m", /* LOG_DONE */
-            "\033[0;94m"  /* LOG_DEBUG */
-        };
-        _f_color = _s;
-        break;
-
-    case args::LOG_COLORS_BOLD:
-        _color = {
-            "\033[1;31m", /* LOG_ERR */
-            "\033[1;33m", /* LOG_WARN */
-            "\033[1;37m", /* LOG_INFO */
-            "\033[1;35m", /* LOG_TIME */
-            "\033[1;32m", /* LOG_DONE */
-            "\033[1;34m"  /* LOG_DEBUG */
-        };
-        _f_color = _s;
-        break;
-
-    case args::LOG_COLORS_BACKGROUND:
-        _color = {
-            "\033[0;41m", /* LOG_ERR */
-            "\033[0;43m", /* LOG_WARN */
-            "\033[0;47m", /* LOG_INFO */
-            "\033[0;45m", /* LOG_TIME */
-            "\033[0;42m", /* LOG_DONE */
-            "\033[0;44m"  /* LOG_DEBUG */
-        };
-        _f_color = _s;
-        break;
-
-    case args::LOG_COLORS_UNDERLINE:
-        _color = {
-            "\033[4;31m", /* LOG_ERR */
-            "\033[4;33m", /* LOG_WARN */
-            "\033[4;37m", /* LOG_INFO */
-            "\033[4;35m", /* LOG_TIME */
-            "\033[4;32m", /* LOG_DONE */
-            "\033[4;34m"  /* LOG_DEBUG */
-        };
-        _f_color = _s;
-        break;
-
-        
-    }
-}
-
-void Logger::set_log_file_path(string _path){///> IN_PROGRESS
-    _file_path.append(_path);
-}
-
-}
\ No newline at end of file
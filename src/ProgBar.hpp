@@ -1,12 +1,14 @@
 #pragma once
 
-#include <iostream>
 #include <chrono>
-#include <iomanip>
 #include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
 
-using namespace std;
-using namespace chrono;
+#include <LogTty.hpp>
 
 namespace cpp_up{
 
@@ -15,7 +17,7 @@ namespace cpp_up{
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <typename T>
-string format_duration(T xms) {
+std::string format_duration(T xms) {
     uint64_t seconds = static_cast<uint64_t>(xms);
     uint64_t days = 0;
     uint64_t hours = 0;
@@ -34,48 +36,48 @@ string format_duration(T xms) {
         seconds -= (minutes * 60);
     }
 
-    stringstream ss;
+    std::stringstream ss;
     if (days > 0) {
-        ss << setfill('0') << setw(2) << days << '-';
+        ss << std::setfill('0') << std::setw(2) << days << '-';
     }
     if (hours > 0) {
-        ss << setfill('0') << setw(2) << hours << ':';
+        ss << std::setfill('0') << std::setw(2) << hours << ':';
     }
     if (minutes > 0) {
-        ss << setfill('0') << setw(2) << minutes << ':';
+        ss << std::setfill('0') << std::setw(2) << minutes << ':';
     }
     // Always display seconds no matter what
-    ss << setfill('0') << setw(2) << seconds;
+    ss << std::setfill('0') << std::setw(2) << seconds;
     return ss.str();
 }
 
 template <typename T>
 class ProgBar {
 public:
-    inline              ProgBar                 (ostream& f, T max, uint64_t poll_interval = 1000, uint64_t width = 30, string unit = "")
-      : _max(static_cast<double>(max)), _sum(0), _state(0), _incr(0), _fac(f), _width(width), _unit(unit), _final(false)
+    inline              ProgBar                 (std::ostream& f, T max, uint64_t poll_interval = 1000, uint64_t width = 30, std::string unit = "")
+      : _max(static_cast<double>(max)), _sum(0), _state(0), _incr(0), _fac(f), _width(width), _unit(unit), _final(false), _tty(LogTty::is_tty(f))
     {
         _incr = _max / static_cast<double>(_width);
-        _start = system_clock::now();
+        _start = std::chrono::system_clock::now();
         _before = _start;
         _state = _incr;
-        _poll_interval = milliseconds(poll_interval);
-        _fac << setprecision(2) << fixed;
+        _poll_interval = std::chrono::milliseconds(poll_interval);
+        _fac << std::setprecision(2) << std::fixed;
         _fac.flush();
     };
     inline void         check                   () {
-        system_clock::time_point now = system_clock::now();
-        milliseconds diff = duration_cast<milliseconds>(now - _before);
+        std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+        std::chrono::milliseconds diff = std::chrono::duration_cast<std::chrono::milliseconds>(now - _before);
         if (diff > _poll_interval) {
-            seconds diff_start = duration_cast<seconds>(now - _start);
-            double ds = duration<double>(diff_start).count();
+            std::chrono::seconds diff_start = std::chrono::duration_cast<std::chrono::seconds>(now - _start);
+            double ds = std::chrono::duration<double>(diff_start).count();
             double dss = _sum / ds;
 
-            int64_t dss_i = ceil((_max - _sum) / dss);
+            int64_t dss_i = std::ceil((_max - _sum) / dss);
 
-            auto eta = duration<uint64_t>(dss_i);
+            auto eta = std::chrono::duration<uint64_t>(dss_i);
 
-            string prefix = "";
+            std::string prefix = "";
             if (dss > 1e15) {
                 prefix = "P";
                 dss /= 1e15;
@@ -93,12 +95,18 @@ public:
                 dss /= 1e3;
             }
             _before = now;
-            _fac << "\r" << flush;
+            if (_tty){
+                _fac << "\r";                                                       ///> redraw in place
+            }
             _fac << "[";
             for (double i = 0; i < _max; i += _incr) {
                 _fac << (i < _sum ? "#" : ".");
             }
-            _fac << "] " << (_sum / _max) * 100 << "% | " << dss << " " << prefix << _unit << "/s | " << format_duration<uint64_t>(diff_start.count()) << " | " << format_duration<uint64_t>(eta.count()) << flush;
+            _fac << "] " << (_sum / _max) * 100 << "% | " << dss << " " << prefix << _unit << "/s | " << format_duration<uint64_t>(diff_start.count()) << " | " << format_duration<uint64_t>(eta.count());
+            if (!_tty){
+                _fac << '\n';                                                       ///> files & pipes: one line per poll
+            }
+            _fac << std::flush;
             if (_sum >= _max) {
                 finalize();
             }
@@ -106,12 +114,16 @@ public:
     }
     inline void         finalize                () {
         if (!_final) {
-            _fac << endl;
+            if (_tty) {
+                _fac << std::endl;
+            }
             _final = true;
             _fac.flush();
         }
     }
 
+    inline void         set_tty                 (bool t) { _tty = t; }              ///> Override terminal detection (false: plain lines, no '\r' redraws)
+
     /*
     *   Increment progress
     */
@@ -142,13 +154,14 @@ private:
     double              _sum;
     double              _state;
     double              _incr;
-    ostream&            _fac;
+    std::ostream&       _fac;
     uint64_t            _width;
-    milliseconds                _poll_interval;
-    system_clock::time_point    _before;
-    system_clock::time_point    _start;
-    string              _unit;
+    std::chrono::milliseconds   _poll_interval;
+    std::chrono::system_clock::time_point _before;
+    std::chrono::system_clock::time_point _start;
+    std::string         _unit;
     bool                _final;
+    bool                _tty;
 };
 
 
@@ -0,0 +1,190 @@
+#include <ProgSpin.hpp>
+
+#include <ostream>
+
+using namespace std;
+
+namespace cpp_up{
+
+ProgSpin::ProgSpin(ostream& _f)
+    : _fac(_f), _tty(LogTty::is_tty(_f))
+{}
+
+string ProgSpin::prep_spinner(){
+    //set the speed of changes
+    if (_f_interrupt != _status_it::COMPLETE){
+        ++_style_it;
+        if (_style_it >= _style.size() - 1){
+            _style_it = 0;
+        }
+        return _style.at(_style_it);
+    }
+    return _style.at(_style.size() - 1);
+}
+
+string ProgSpin::prep_percent(){
+    return to_string(_progress) + "%";
+}
+
+string ProgSpin::prep_status(){
+    if (_f_interrupt == _status_it::IN_PROGRESS){
+        return _status.at(_status_it::IN_PROGRESS);
+    }
+    else if (_f_interrupt == _status_it::COMPLETE){
+        return _status.at(_status_it::COMPLETE);
+    }
+    else if (_f_interrupt == _status_it::ERROR) {
+        return _status.at(_status_it::ERROR);
+    }
+    return "";
+}
+
+string ProgSpin::prep_iterations(){
+    return to_string(_size_it) + "\033[1;31m:\033[0;0m" + to_string(_size_max);
+}
+
+string ProgSpin::prep_txt(){
+    return "NOTE \033[1;31m:\033[0;0m \033[1;96m" + _curr_txt + "\033[0;0m";
+}
+
+
+
+void ProgSpin::update(){
+    //compute progress
+    ++_curr_it;
+    ++_size_it;
+    if (_curr_it >= _one_prct){
+        ++_progress;
+        _curr_it = 0;
+    }
+    if (_progress >= 0 && _progress < 100){
+        _f_interrupt = _status_it::IN_PROGRESS;
+    }
+    else if (_progress >= 100){
+        _f_interrupt = _status_it::COMPLETE;
+    }
+    
+    //change UI
+    if (!_tty && _progress / 10 == _printed){
+        return;                                                                     ///> nothing new for a file/pipe
+    }
+    // _fac <<  prep_spinner() + prep_percent() + prep_status() + prep_iterations();
+    draw("╰─\033[1;31m[\033[0;0m " + prep_spinner() + " " + prep_percent() + "\033[1;31m ][ \033[0;0m" + prep_status() + " " + prep_iterations() + "\033[1;31m ]\033[0;0m", false);
+}
+
+void ProgSpin::draw(const string& line, bool force){
+    if (_tty){
+        _fac << "\r" << line;
+        _fac.flush();
+        return;
+    }
+    if (!force && _progress / 10 == _printed){
+        return;
+    }
+    _printed = _progress / 10;
+    string plain;
+    LogTty::strip(plain, line);
+    _fac << plain << '\n';
+}
+
+void ProgSpin::reset(){
+    //change UI to final state
+    // _fac <<  prep_spinner() + prep_percent() + prep_status() + prep_iterations();
+    draw("╰─\033[1;31m[\033[0;0m " + prep_spinner() + " " + prep_percent() + "\033[1;31m ][ \033[0;0m" + prep_status() + " " + prep_iterations() + "\033[1;31m ]\033[0;0m", true);
+    if (_tty){
+        _fac << endl;
+    }
+    else{
+        _fac.flush();
+    }
+
+    //reset all values
+    _style_it = 0;
+    _curr_it = 0;
+    _progress = 0;
+    _one_prct = 0;
+    _size_it = 0;
+    _size_max = 0;
+    _curr_txt.clear();
+    _curr_txt.append("Iteration");
+    _f_interrupt = _status_it::IN_PROGRESS;
+    _printed = -1;
+}
+
+void ProgSpin::done(){
+    _f_interrupt = _status_it::COMPLETE;
+}
+
+void ProgSpin::error(){
+    _f_interrupt = _status_it::ERROR;
+}
+
+void ProgSpin::process(const uint64_t _size){
+    //set 1% value
+    _one_prct = _size / 100;
+    _size_max = _size;
+    string head = "╭─\033[1;31m[ \033[0;0m" + prep_txt() + "\033[1;31m ]\033[0;0m";
+    if (!_tty){
+        string plain;
+        LogTty::strip(plain, head);
+        head.swap(plain);
+    }
+    _fac << head << endl;
+}
+
+void ProgSpin::process(const uint64_t _size, const string _txt){
+    //add txt
+    _curr_txt.clear();
+    _curr_txt.append(_txt);
+    process(_size);
+}
+
+void ProgSpin::set_style(const args::ps_style _s){
+    switch (_s)
+    {
+    case args::PS_STYLE_SQUARE:
+        _style = {
+            // "\033[1;31m    \033[0;0m",
+            "\033[1;31m⬚\033[0;0m",
+            "\033[1;31m◼\033[0;0m",
+            "\033[1;31m⬚\033[0;0m",
+            "\033[1;31m \033[0;0m",
+            "\033[1;31m⬚\033[0;0m",
+            "\033[1;31m◼\033[0;0m",
+            "\033[1;31m⬚\033[0;0m",
+            "\033[1;31m \033[0;0m",
+            "\033[1;31m◼\033[0;0m"   /* FINAL */
+        };
+        break;
+
+    case args::PS_STYLE_CIRCLE:
+        _style = {
+            "\033[1;31m⠈\033[0;0m",
+            "\033[1;31m⠐\033[0;0m",
+            "\033[1;31m⠠\033[0;0m",
+            "\033[1;31m⢀\033[0;0m",
+            "\033[1;31m⡀\033[0;0m",
+            "\033[1;31m⠄\033[0;0m",
+            "\033[1;31m⠂\033[0;0m",
+            "\033[1;31m⠁\033[0;0m",
+            "\033[1;31m⣿\033[0;0m"   /* FINAL */
+        };
+        break;
+
+    case args::PS_STYLE_LINUX:
+        _style = {
+            "\033[1;31m|\033[0;0m",
+            "\033[1;31m╱\033[0;0m",
+            "\033[1;31m—\033[0;0m",
+            "\033[1;31m╲\033[0;0m",
+            "\033[1;31m|\033[0;0m",
+            "\033[1;31m╱\033[0;0m",
+            "\033[1;31m—\033[0;0m",
+            "\033[1;31m╲\033[0;0m",
+            "\033[1;31mX\033[0;0m"   /* FINAL */
+        };
+        break;
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <LogSink.hpp>
+#include <Logger.hpp>
+#include <alloc_count.hpp>
+
+using namespace std;
+using namespace cpp_up;
+using namespace args;
+
+/*
+*   cpp_up_test_alloc: a steady-state log line does no heap allocation
+*   - every line format (modules, pattern, JSON Lines) and argument kind, sync mode, after a warm-up
+*   - fails (exit 1) with the number of allocations per case
+*/
+
+/*
+*   Sink that only counts bytes (the sink itself must not allocate either)
+*/
+class CountSink : public LogSink{
+public:
+    void                write                   (const char*, size_t n, unsigned) override { bytes += n; }
+    uint64_t            bytes                   {0};
+};
+
+struct point{
+    int                 x, y;
+};
+static ostream& operator<<(ostream& os, const point& p){
+    return os << '(' << p.x << ", " << p.y << ')';
+}
+
+static void lines(Logger& log, int n){
+    string name = "storage";
+    point p {3, 4};
+    for (int i = 0; i < n; ++i){
+        LOG_MSG_TO(log, LOG_INFO) << "request " << i << " of " << name << " took " << 1.25 * i << "ms " << p << ' ' << true;
+        LOG_MSG_TO(log, LOG_DEBUG) << "disabled " << i;
+        LOG_MSG_TO(log, LOG_WARN) << "login" << log_kv("user", name) << log_kv("ms", i) << log_kv("ok", i % 2 == 0);
+        log(LOG_ERR) << "call operator " << static_cast<uint64_t>(i) << " " << -i;
+    }
+}
+
+static bool check(Logger& log, const char* what){
+    lines(log, 1000);                                                               ///> warm-up: thread buffers, time cache, layouts
+    uint64_t before = alloc_count();
+    lines(log, 20000);
+    uint64_t n = alloc_count() - before;
+    printf("%-24s %llu allocations\n", what, static_cast<unsigned long long>(n));
+    return n == 0;
+}
+
+int main(){
+    ostringstream unused;
+    Logger& log = Logger::get_instance(unused);
+    log.remove_sink(log.add_sink(unused));
+    auto sink = make_shared<CountSink>();
+    log.add_sink(sink);
+    log.set_log_level(LOG_DONE);
+
+    bool ok = check(log, "plain");
+    log.set_log_style_time(LOG_STYLE_ON);
+    log.set_log_style_status(LOG_STYLE_ON);
+    ok &= check(log, "time & status");
+    log.set_log_pattern("%Y-%m-%d %H:%M:%S.%f [%^%L%$] %t %@ %v");
+    ok &= check(log, "pattern");
+    log.set_log_format(LOG_FORMAT_JSON);
+    ok &= check(log, "JSON Lines");
+    log.remove_sink(sink);
+    if (!ok || sink->bytes == 0){
+        printf("FAILED: the steady-state hot path allocates\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <alloc_count.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Allocation counter                                                                                              //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static atomic<uint64_t> g_allocs {0};
+
+uint64_t alloc_count(){
+    return g_allocs.load(memory_order_relaxed);
+}
+
+static void* counted(size_t n, size_t align){
+    g_allocs.fetch_add(1, memory_order_relaxed);
+    n = n ? n : 1;
+    if (align <= alignof(max_align_t)){
+        return malloc(n);
+    }
+    return aligned_alloc(align, (n + align - 1) / align * align);                  ///> size: multiple of the alignment
+}
+
+static void* counted_or_throw(size_t n, size_t align){
+    if (void* p = counted(n, align)){
+        return p;
+    }
+    throw bad_alloc();
+}
+
+void* operator new      (size_t n)                                          { return counted_or_throw(n, 0); }
+void* operator new[]    (size_t n)                                          { return counted_or_throw(n, 0); }
+void* operator new      (size_t n, align_val_t a)                           { return counted_or_throw(n, static_cast<size_t>(a)); }
+void* operator new[]    (size_t n, align_val_t a)                           { return counted_or_throw(n, static_cast<size_t>(a)); }
+void* operator new      (size_t n, const nothrow_t&) noexcept               { return counted(n, 0); }
+void* operator new[]    (size_t n, const nothrow_t&) noexcept               { return counted(n, 0); }
+void* operator new      (size_t n, align_val_t a, const nothrow_t&) noexcept { return counted(n, static_cast<size_t>(a)); }
+void* operator new[]    (size_t n, align_val_t a, const nothrow_t&) noexcept { return counted(n, static_cast<size_t>(a)); }
+
+void  operator delete   (void* p) noexcept                                  { free(p); }
+void  operator delete[] (void* p) noexcept                                  { free(p); }
+void  operator delete   (void* p, size_t) noexcept                          { free(p); }
+void  operator delete[] (void* p, size_t) noexcept                          { free(p); }
+void  operator delete   (void* p, align_val_t) noexcept                     { free(p); }
+void  operator delete[] (void* p, align_val_t) noexcept                     { free(p); }
+void  operator delete   (void* p, size_t, align_val_t) noexcept             { free(p); }
+void  operator delete[] (void* p, size_t, align_val_t) noexcept             { free(p); }
+void  operator delete   (void* p, const nothrow_t&) noexcept                { free(p); }
+void  operator delete[] (void* p, const nothrow_t&) noexcept                { free(p); }
+void  operator delete   (void* p, align_val_t, const nothrow_t&) noexcept   { free(p); }
+void  operator delete[] (void* p, align_val_t, const nothrow_t&) noexcept   { free(p); }
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+*   Global operator new/delete replaced by malloc/free with a counter (alloc_count.cpp, one copy per executable)
+*   - every form is replaced (sized, array, aligned, nothrow), so no delete pairs with a foreign new
+*/
+uint64_t                alloc_count             ();                                 ///> operator new calls so far, all threads
@@ -0,0 +1,144 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <LogSink.hpp>
+#include <Logger.hpp>
+
+using namespace std;
+using namespace chrono;
+using namespace cpp_up;
+using namespace args;
+
+/*
+*   cpp_up_test_async: background writer modes under load
+*   - LOG_ASYNC_BLOCK with a slow sink: producers sleep on a full queue instead of spinning, no line is lost
+*   - set_log_async() switched back & forth while threads log: every line arrives exactly once
+*/
+
+static bool g_ok = true;
+
+static void expect(bool cond, const string& what){
+    printf("%-72s %s\n", what.c_str(), cond ? "ok" : "FAILED");
+    g_ok &= cond;
+}
+
+/*
+*   Counts lines, optionally sleeping per write
+*/
+class counter : public LogSink{
+public:
+    explicit counter(microseconds delay = microseconds(0)) : _delay(delay) {}
+
+    void write(const char* p, size_t n, unsigned) override{
+        for (size_t i = 0; i < n; ++i){
+            _lines += p[i] == '\n';
+        }
+        if (_delay.count()){
+            this_thread::sleep_for(_delay);
+        }
+    }
+    bool batched() const override { return false; }
+
+    atomic<uint64_t>    _lines                  {0};
+    microseconds        _delay;
+};
+
+static double thread_cpu_ms(){
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+}
+
+/*
+*   4 producers against a sink taking 1ms per line & a 16 slot queue: wall time is the sink's, CPU time stays low
+*/
+static void block(){
+    ostringstream unused;
+    Logger log(unused);
+    log.remove_sink(log.add_sink(unused));
+    log.set_log_level(LOG_DONE);
+    auto sink = make_shared<counter>(milliseconds(1));
+    log.add_sink(sink);
+    log.set_log_async(LOG_ASYNC_BLOCK, 16);
+
+    const unsigned threads = 4, n = 100;
+    vector<double> cpu(threads), wall(threads);
+    vector<thread> th;
+    for (unsigned t = 0; t < threads; ++t){
+        th.emplace_back([&, t]{
+            steady_clock::time_point w0 = steady_clock::now();
+            double c0 = thread_cpu_ms();
+            for (unsigned i = 0; i < n; ++i){
+                LOG_MSG_TO(log, LOG_INFO) << "block line " << i << " of thread " << t;
+            }
+            cpu[t]  = thread_cpu_ms() - c0;
+            wall[t] = duration<double, milli>(steady_clock::now() - w0).count();
+        });
+    }
+    for (thread& x : th){
+        x.join();
+    }
+    log.flush();
+    double c = 0, w = 0;
+    for (unsigned t = 0; t < threads; ++t){
+        c += cpu[t];
+        w += wall[t];
+    }
+    expect(sink->_lines.load() == threads * n, "LOG_ASYNC_BLOCK: " + to_string(sink->_lines.load()) + " of " + to_string(threads * n) + " lines written");
+    expect(c < w / 4, "LOG_ASYNC_BLOCK: producers used " + to_string(static_cast<int>(c)) + "ms CPU in " + to_string(static_cast<int>(w)) + "ms waiting");
+    log.remove_sink(sink);
+}
+
+/*
+*   Mode switched every millisecond while 4 threads log: nothing lost, nothing twice
+*/
+static void switching(){
+    ostringstream unused;
+    Logger log(unused);
+    log.remove_sink(log.add_sink(unused));
+    log.set_log_level(LOG_DONE);
+    auto sink = make_shared<counter>();
+    log.add_sink(sink);
+
+    const unsigned threads = 4, n = 100000;
+    atomic<unsigned> running {threads};
+    vector<thread> th;
+    for (unsigned t = 0; t < threads; ++t){
+        th.emplace_back([&, t]{
+            for (unsigned i = 0; i < n; ++i){
+                LOG_MSG_TO(log, LOG_INFO) << "switch line " << i << " of thread " << t;
+            }
+            running.fetch_sub(1);
+        });
+    }
+    static const unsigned modes[] {LOG_ASYNC_BLOCK, LOG_ASYNC_OFF, LOG_ASYNC_BLOCK, LOG_ASYNC_BLOCK};
+    unsigned switches = 0;
+    while (running.load() != 0){
+        log.set_log_async(modes[switches++ % 4], 64);
+        this_thread::sleep_for(milliseconds(1));
+    }
+    for (thread& x : th){
+        x.join();
+    }
+    log.set_log_async(LOG_ASYNC_OFF);
+    expect(sink->_lines.load() == threads * n, "set_log_async x" + to_string(switches) + " while logging: " + to_string(sink->_lines.load())
+           + " of " + to_string(threads * n) + " lines");
+    log.remove_sink(sink);
+}
+
+int main(){
+    block();
+    switching();
+    if (!g_ok){
+        printf("FAILED: async writer lost lines or spun on a full queue\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <LogCompress.hpp>
+
+using namespace std;
+using namespace cpp_up;
+
+/*
+*   cpp_up_test_compress: the CPZ1 codec & frame round-trip, damaged input is rejected, CompressedFileSink rotates
+*   - blocks: empty, tiny, incompressible, long & overlapping matches, long literal runs, log lines
+*   - frames: empty & multi-block streams, bad magic, truncated at every header & payload boundary
+*   - sink: rotated parts end up as '.1.cpz' .. '.N.cpz' holding the newest lines, in order, nothing left behind
+*/
+
+static bool g_ok = true;
+
+static void expect(bool cond, const string& what){
+    printf("%-72s %s\n", what.c_str(), cond ? "ok" : "FAILED");
+    g_ok &= cond;
+}
+
+static string log_lines(size_t n, uint32_t seed){
+    mt19937 gen(seed);
+    auto rng = [&]{ return static_cast<unsigned>(gen()); };
+    static const char* paths[] {"/api/v1/items", "/api/v1/users", "/health", "/api/v2/orders"};
+    string s;
+    char line[256];
+    while (s.size() < n){
+        int len = snprintf(line, sizeof(line), "2026-10-17 14:36:%02u.%06u [INFO ] %u request id=%08x path=%s/%u took %uus status=%u\n",
+                           rng() % 60, rng() % 1000000, 4000 + rng() % 8, rng(), paths[rng() % 4], rng() % 10000, rng() % 5000,
+                           rng() % 8 ? 200 : 500);
+        s.append(line, static_cast<size_t>(len));
+    }
+    s.resize(n);
+    return s;
+}
+
+static string random_bytes(size_t n, uint32_t seed){
+    mt19937 rng(seed);
+    string s(n, '\0');
+    for (char& c : s){
+        c = static_cast<char>(rng());
+    }
+    return s;
+}
+
+/*
+*   Block round-trip: fits bound(), decodes to the input, a wrong raw size or a cut block is rejected
+*/
+static void block(const string& name, const string& in){
+    vector<char> packed(LogCodec::bound(in.size()) + 8);
+    size_t c = LogCodec::compress(in.data(), in.size(), packed.data());
+    string out(in.size(), '\0');
+    bool ok = c <= LogCodec::bound(in.size()) && LogCodec::decompress(packed.data(), c, &out[0], out.size()) && out == in;
+    char ratio[32];
+    snprintf(ratio, sizeof(ratio), "%.2fx", c ? static_cast<double>(in.size()) / static_cast<double>(c) : 0.0);
+    expect(ok, "block " + name + ": " + to_string(in.size()) + " -> " + to_string(c) + " bytes (" + ratio + ")");
+
+    string big(in.size() + 1, '\0');
+    bool wrong = !LogCodec::decompress(packed.data(), c, &big[0], big.size())
+              && (in.empty() || !LogCodec::decompress(packed.data(), c, &out[0], out.size() - 1));
+    bool cut = true;
+    for (size_t n = 0; n < c; n += 1 + c / 64){
+        string tmp(in.size(), '\0');
+        cut &= !LogCodec::decompress(packed.data(), n, &tmp[0], tmp.size()) || in.empty();
+    }
+    expect(wrong && cut, "block " + name + ": wrong raw size & cut blocks rejected");
+}
+
+static string frame(const string& in){
+    FILE* src = tmpfile();
+    FILE* dst = tmpfile();
+    fwrite(in.data(), 1, in.size(), src);
+    rewind(src);
+    string out;
+    if (LogCodec::compress_file(src, dst)){
+        out.resize(static_cast<size_t>(ftell(dst)));
+        rewind(dst);
+        out.resize(fread(&out[0], 1, out.size(), dst));
+    }
+    fclose(src);
+    fclose(dst);
+    return out;
+}
+
+static bool unframe(const string& in, string& out){
+    FILE* src = tmpfile();
+    FILE* dst = tmpfile();
+    fwrite(in.data(), 1, in.size(), src);
+    rewind(src);
+    bool ok = LogCodec::decompress_file(src, dst);
+    out.resize(static_cast<size_t>(ftell(dst)));
+    rewind(dst);
+    out.resize(fread(&out[0], 1, out.size(), dst));
+    fclose(src);
+    fclose(dst);
+    return ok;
+}
+
+/*
+*   Frame round-trip, then the same frame cut at block headers, inside them & inside payloads
+*/
+static void frames(const string& name, const string& in){
+    string f = frame(in), out;
+    expect(!f.empty() && unframe(f, out) && out == in, "frame " + name + ": " + to_string(in.size()) + " -> " + to_string(f.size()) + " bytes");
+
+    vector<size_t> cuts {0, 2, 4, 7, f.size() - 8, f.size() - 1};
+    for (size_t at = 4; at + 8 <= f.size() - 8;){                                  ///> every block header
+        uint32_t stored = static_cast<uint32_t>(static_cast<uint8_t>(f[at + 4]) | static_cast<uint8_t>(f[at + 5]) << 8
+                        | static_cast<uint8_t>(f[at + 6]) << 16 | static_cast<uint32_t>(static_cast<uint8_t>(f[at + 7])) << 24);
+        size_t c = stored & 0x7FFFFFFFu;
+        cuts.insert(cuts.end(), {at, at + 3, at + 8, at + 8 + c / 2});
+        at += 8 + c;
+    }
+    bool rejected = true;
+    for (size_t n : cuts){
+        rejected &= !unframe(f.substr(0, n), out);
+    }
+    string bad = f;
+    bad[3] = '2';
+    rejected &= !unframe(bad, out);
+    expect(rejected, "frame " + name + ": bad magic & " + to_string(cuts.size()) + " truncations rejected");
+}
+
+static vector<string> dir_files(const string& dir){
+    vector<string> names;
+    if (DIR* d = opendir(dir.c_str())){
+        while (dirent* e = readdir(d)){
+            string n = e->d_name;
+            if (n != "." && n != ".."){
+                names.push_back(n);
+            }
+        }
+        closedir(d);
+    }
+    return names;
+}
+
+/*
+*   Rotate every ~4 KB with 3 files kept: live file + '.1.cpz' .. '.3.cpz' hold the newest lines in order
+*/
+static void rotation(const string& dir){
+    const string path = dir + "/app.log";
+    const unsigned n = 2000;
+    {
+        FileSink::config cfg;
+        cfg.rotate_bytes = 4 << 10;
+        cfg.max_files    = 3;
+        CompressedFileSink sink(path, cfg);
+        for (unsigned i = 0; i < n; ++i){
+            string line = "rotation line " + to_string(i) + " padding padding padding padding\n";
+            sink.write(line.data(), line.size(), 2);
+            if (i % 100 == 99){
+                sink.flush();                                                       ///> rotation happens on the I/O thread
+            }
+        }
+    }                                                                               ///> compresses pending parts, then joins
+
+    vector<string> names = dir_files(dir);
+    bool leftovers = false;
+    for (const string& f : names){
+        leftovers |= f.find(".part-") != string::npos || f.find(".tmp") != string::npos;
+    }
+    string text;
+    bool ok = true;
+    for (unsigned k = 3; k >= 1; --k){
+        FILE* in = fopen((path + "." + to_string(k) + ".cpz").c_str(), "rb");
+        string packed, out;
+        if (!in){
+            ok = false;
+            continue;
+        }
+        char buf[4096];
+        size_t r;
+        while ((r = fread(buf, 1, sizeof(buf), in)) > 0){
+            packed.append(buf, r);
+        }
+        fclose(in);
+        ok &= unframe(packed, out);
+        text += out;
+    }
+    FILE* live = fopen(path.c_str(), "rb");
+    if (live){
+        char buf[4096];
+        size_t r;
+        while ((r = fread(buf, 1, sizeof(buf), live)) > 0){
+            text.append(buf, r);
+        }
+        fclose(live);
+    }
+    ///> consecutive whole lines ending with the last one written
+    unsigned expect_next = 0, count = 0;
+    bool ordered = !text.empty() && text.back() == '\n';
+    for (size_t at = 0; ordered && at < text.size();){
+        size_t nl = text.find('\n', at);
+        unsigned i = static_cast<unsigned>(strtoul(text.c_str() + at + 14, nullptr, 10));
+        ordered = text.compare(at, 14, "rotation line ") == 0 && (count == 0 || i == expect_next);
+        expect_next = i + 1;
+        ++count;
+        at = nl + 1;
+    }
+    expect(names.size() == 4 && !leftovers, "rotation: " + to_string(names.size()) + " files (live + 3 .cpz), no parts left");
+    expect(ok && ordered && expect_next == n, "rotation: newest " + to_string(count) + " lines of " + to_string(n) + " in order");
+}
+
+int main(){
+    block("empty", "");
+    block("1 byte", "x");
+    block("12 bytes", "abcdabcdabcd");
+    block("13 bytes", "abcdabcdabcda");
+    block("incompressible 64KB", random_bytes(64 << 10, 1));
+    block("run of 1MB 'a'", string(LogCodec::BLOCK, 'a'));                         ///> offset 1: overlapping copy
+    block("period 3", [] { string s; while (s.size() < 100000) s += "abc"; return s; }());
+    block("long literals + long match", random_bytes(1000, 2) + string(5000, 'z') + random_bytes(1000, 3));
+    block("log lines 1MB", log_lines(LogCodec::BLOCK, 4));
+
+    frames("empty", "");
+    frames("log lines 2.5MB", log_lines(LogCodec::BLOCK * 5 / 2, 5));
+    frames("incompressible 1MB + 1", random_bytes(LogCodec::BLOCK + 1, 6));        ///> stored blocks
+
+    char dir[] = "/tmp/cpp_up_test_compress.XXXXXX";
+    if (!mkdtemp(dir)){
+        perror("mkdtemp");
+        return 2;
+    }
+    rotation(dir);
+    for (const string& f : dir_files(dir)){
+        remove((string(dir) + "/" + f).c_str());
+    }
+    rmdir(dir);
+    if (!g_ok){
+        printf("FAILED: CPZ1 round-trip or CompressedFileSink rotation\n");
+        return 1;
+    }
+    return 0;
+}
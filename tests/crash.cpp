@@ -0,0 +1,118 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <LogFile.hpp>
+#include <Logger.hpp>
+
+using namespace std;
+using namespace chrono;
+using namespace cpp_up;
+using namespace args;
+
+/*
+*   cpp_up_test_crash: Logger::emergency_flush() writes queued async lines into the log file, not to stderr
+*   - the async writer is held inside a gated sink, so the next lines stay queued when the flush runs
+*/
+
+static bool g_ok = true;
+
+static void expect(bool cond, const string& what){
+    printf("%-72s %s\n", what.c_str(), cond ? "ok" : "FAILED");
+    g_ok &= cond;
+}
+
+/*
+*   Sink whose write() waits until it is opened: keeps the async writer busy; counts its crash path lines
+*/
+class gate : public LogSink{
+public:
+    void write(const char*, size_t, unsigned) override{
+        _entered.store(true);
+        while (!_open.load()){
+            this_thread::sleep_for(milliseconds(1));
+        }
+    }
+    bool emergency_write(const char*, size_t) override{
+        ++_crash_lines;
+        return true;
+    }
+    bool batched() const override { return false; }
+
+    atomic<bool>        _entered                {false};
+    atomic<bool>        _open                   {false};
+    atomic<unsigned>    _crash_lines            {0};
+};
+
+static unsigned count(const string& path, const string& text){
+    FILE* f = fopen(path.c_str(), "rb");
+    string all;
+    if (f){
+        char buf[4096];
+        size_t r;
+        while ((r = fread(buf, 1, sizeof(buf), f)) > 0){
+            all.append(buf, r);
+        }
+        fclose(f);
+    }
+    unsigned n = 0;
+    for (size_t at = all.find(text); at != string::npos; at = all.find(text, at + 1)){
+        ++n;
+    }
+    return n;
+}
+
+int main(){
+    char dir[] = "/tmp/cpp_up_test_crash.XXXXXX";
+    if (!mkdtemp(dir)){
+        perror("mkdtemp");
+        return 2;
+    }
+    const string path = string(dir) + "/app.log";
+    const unsigned n = 100;
+    {
+        ostringstream unused;
+        Logger log(unused);
+        log.remove_sink(log.add_sink(unused));
+        log.set_log_level(LOG_DONE);
+
+        auto file = make_shared<FileSink>(path, FileSink::config());
+        auto g    = make_shared<gate>();
+        for (int i = 0; i < 500 && !file->is_open(); ++i){
+            this_thread::sleep_for(milliseconds(10));
+        }
+        log.add_sink(file);
+        log.add_sink(g);
+        log.set_log_async(LOG_ASYNC_BLOCK, 1024);
+
+        LOG_MSG_TO(log, LOG_INFO) << "held line";
+        for (int i = 0; i < 500 && !g->_entered.load(); ++i){
+            this_thread::sleep_for(milliseconds(10));
+        }
+        for (unsigned i = 0; i < n; ++i){
+            LOG_MSG_TO(log, LOG_INFO) << "queued line " << i;
+        }
+        log.emergency_flush();
+        unsigned got = count(path, "queued line ");
+        expect(g->_entered.load() && got == n, "emergency_flush: " + to_string(got) + " of " + to_string(n) + " queued lines in the log file");
+        expect(g->_crash_lines.load() == n, "emergency_flush: " + to_string(g->_crash_lines.load()) + " of " + to_string(n) + " through the crash path of a 2nd sink");
+
+        g->_open.store(true);
+        log.flush();
+        log.remove_sink(g);
+        log.remove_sink(file);
+    }
+    remove(path.c_str());
+    rmdir(dir);
+    if (!g_ok){
+        printf("FAILED: queued async lines missing from the log file after emergency_flush\n");
+        return 1;
+    }
+    return 0;
+}
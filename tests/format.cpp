@@ -0,0 +1,65 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <LogSink.hpp>
+#include <Logger.hpp>
+
+using namespace std;
+using namespace cpp_up;
+using namespace args;
+
+/*
+*   cpp_up_test_format: one rendering per value type on every path
+*   - int8_t/uint8_t are numbers in log_append, in << operands & in log_kv fields (text & JSON), plain char is a character
+*/
+
+static bool g_ok = true;
+
+static void expect(bool cond, const string& what){
+    printf("%-72s %s\n", what.c_str(), cond ? "ok" : "FAILED");
+    g_ok &= cond;
+}
+
+static string appended(){
+    string s;
+    log_append(s, static_cast<int8_t>(-5));
+    s += ' ';
+    log_append(s, static_cast<uint8_t>(200));
+    s += ' ';
+    log_append(s, 'x');
+    return s;
+}
+
+int main(){
+    expect(appended() == "-5 200 x", "log_append: int8_t -5, uint8_t 200, char 'x' -> \"" + appended() + "\"");
+
+    ostringstream unused;
+    Logger log(unused);
+    log.remove_sink(log.add_sink(unused));
+    log.set_log_level(LOG_DONE);
+    auto sink = make_shared<MemorySink>();
+    log.add_sink(sink);
+    log.set_log_pattern("%v");
+
+    for (unsigned f : {LOG_FORMAT_TEXT, LOG_FORMAT_JSON}){
+        sink->clear();
+        log.set_log_format(f);
+        LOG_MSG_TO(log, LOG_INFO) << static_cast<uint8_t>(7) << ' ' << static_cast<int8_t>(-3) << ' ' << 'c'
+                                  << log_kv("u8", static_cast<uint8_t>(7)) << log_kv("i8", static_cast<int8_t>(-3));
+        log.flush();
+        string line = sink->lines().empty() ? "" : sink->lines().back();
+        bool ok = f == LOG_FORMAT_TEXT ? line.find("7 -3 c") != string::npos && line.find("u8=7") != string::npos && line.find("i8=-3") != string::npos
+                                       : line.find("7 -3 c") != string::npos && line.find("\"u8\":7") != string::npos && line.find("\"i8\":-3") != string::npos;
+        expect(ok, string(f == LOG_FORMAT_TEXT ? "text: " : "json: ") + line);
+    }
+    log.remove_sink(sink);
+
+    if (!g_ok){
+        printf("FAILED: int8_t/uint8_t rendered differently on two paths\n");
+        return 1;
+    }
+    return 0;
+}
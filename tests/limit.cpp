@@ -0,0 +1,58 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include <LogLimit.hpp>
+
+using namespace std;
+using namespace cpp_up;
+
+/*
+*   cpp_up_test_limit: call-site limiters behind LOG_EVERY_N / LOG_FIRST_N / LOG_RATE
+*   - LOG_RATE: a burst of K passes, the next call is skipped & counted; K < 1 still passes the first call
+*/
+
+static bool g_ok = true;
+
+static void expect(bool cond, const string& what){
+    printf("%-72s %s\n", what.c_str(), cond ? "ok" : "FAILED");
+    g_ok &= cond;
+}
+
+static void rate(double per_sec, unsigned burst){
+    LogSite site {nullptr, 0};
+    unsigned passed = 0;
+    for (unsigned i = 0; i < burst; ++i){
+        passed += log_rate(site, per_sec);
+    }
+    bool next = log_rate(site, per_sec);
+    string name = "log_rate " + to_string(per_sec).substr(0, 4) + "/s: ";
+    expect(passed == burst, name + to_string(passed) + " of the first " + to_string(burst) + " calls pass");
+    expect(!next && site.skipped.load() == 1, name + "an immediate next call is skipped & counted");
+}
+
+int main(){
+    rate(0.5, 1);
+    rate(1, 1);
+    rate(10, 10);
+
+    LogSite every {nullptr, 0};
+    unsigned passed = 0;
+    for (unsigned i = 0; i < 10; ++i){
+        passed += log_every_n(every, 3);
+    }
+    expect(passed == 4 && every.skipped.load() == 6, "log_every_n 3: 4 of 10 calls pass, 6 skipped");
+
+    LogSite first {nullptr, 0};
+    passed = 0;
+    for (unsigned i = 0; i < 10; ++i){
+        passed += log_first_n(first, 3);
+    }
+    expect(passed == 3, "log_first_n 3: 3 of 10 calls pass");
+
+    if (!g_ok){
+        printf("FAILED: call-site limiter\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <LogSocket.hpp>
+#include <Logger.hpp>
+
+using namespace std;
+using namespace chrono;
+using namespace cpp_up;
+using namespace args;
+
+/*
+*   cpp_up_test_socket: lines logged through SocketSink reach cpp_up_logrecv, lines it cannot deliver are counted
+*   - unix: & unixgram: sockets in a temp directory, receiver up: every line arrives, none dropped
+*   - receiver stopped, then back / receiver slow: the logger never waits, dropped() counts the overflow,
+*     sent() + dropped() covers every line & the receivers got exactly sent()
+*   - argv[1]: path of cpp_up_logrecv
+*/
+
+static const char* g_recv;
+static bool g_ok = true;
+
+static void expect(bool cond, const string& what){
+    printf("%-72s %s\n", what.c_str(), cond ? "ok" : "FAILED");
+    g_ok &= cond;
+}
+
+/*
+*   cpp_up_logrecv child, the lines it prints are counted through a pipe
+*/
+class receiver{
+public:
+    explicit receiver(const string& address, int delay_ms = 0){
+        int p[2];
+        if (pipe(p) != 0){
+            return;
+        }
+        string d = to_string(delay_ms);
+        _pid = fork();
+        if (_pid == 0){
+            dup2(p[1], 1);
+            close(p[0]);
+            close(p[1]);
+            execl(g_recv, g_recv, "-d", d.c_str(), address.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        close(p[1]);
+        _out = p[0];
+        fcntl(_out, F_SETFL, O_NONBLOCK);
+        string path = address.substr(address.find(':') + 1);
+        for (int i = 0; i < 500 && access(path.c_str(), F_OK) != 0; ++i){
+            this_thread::sleep_for(milliseconds(10));                              ///> bound: the sink can connect
+        }
+    }
+
+    ~receiver(){
+        stop();
+    }
+
+    /*
+    *   Lines printed so far
+    */
+    uint64_t lines(){
+        char buf[1 << 16];
+        ssize_t r;
+        while (_out >= 0 && (r = read(_out, buf, sizeof(buf))) > 0){
+            for (ssize_t i = 0; i < r; ++i){
+                _lines += buf[i] == '\n';
+            }
+        }
+        return _lines;
+    }
+
+    /*
+    *   Wait until n lines were printed (receiver flushes at least every 200ms), false after 10s
+    */
+    bool wait_for(uint64_t n){
+        for (int i = 0; i < 1000 && lines() < n; ++i){
+            this_thread::sleep_for(milliseconds(10));
+        }
+        return lines() >= n;
+    }
+
+    /*
+    *   SIGTERM & reap, lines printed in total
+    */
+    uint64_t stop(){
+        if (_pid > 0){
+            kill(_pid, SIGTERM);
+            int status = 0;
+            waitpid(_pid, &status, 0);
+            _pid = -1;
+            fcntl(_out, F_SETFL, 0);
+            lines();
+            close(_out);
+            _out = -1;
+        }
+        return _lines;
+    }
+
+private:
+    pid_t               _pid                    {-1};
+    int                 _out                    {-1};
+    uint64_t            _lines                  {0};
+};
+
+static void lines(Logger& log, uint64_t from, uint64_t n){
+    for (uint64_t i = from; i < from + n; ++i){
+        LOG_MSG_TO(log, LOG_INFO) << "socket line " << i << " of the cpp_up_test_socket run";
+    }
+}
+
+static shared_ptr<SocketSink> attach(Logger& log, const string& address, size_t max_pending){
+    SocketSink::config cfg;
+    cfg.max_pending    = max_pending;
+    cfg.batch_interval = milliseconds(10);
+    cfg.retry_interval = milliseconds(20);
+    auto s = make_shared<SocketSink>(address, cfg);
+    log.add_sink(s);
+    return s;
+}
+
+/*
+*   Flush until every line is either sent or dropped (nothing left in the sink buffers), false after 10s
+*   - reads the receiver output meanwhile: a full pipe would stall it
+*/
+static bool settle(SocketSink& s, receiver& r, uint64_t n){
+    for (int i = 0; i < 1000 && s.sent() + s.dropped() < n; ++i){
+        s.flush();
+        r.lines();
+        this_thread::sleep_for(milliseconds(10));
+    }
+    return s.sent() + s.dropped() == n;
+}
+
+/*
+*   Receiver up: every line arrives
+*/
+static void delivered(Logger& log, const string& address){
+    const uint64_t n = 20000;
+    receiver r(address);
+    auto s = attach(log, address, 64 << 20);
+    lines(log, 0, n);
+    bool settled = settle(*s, r, n);
+    expect(settled && s->dropped() == 0, address + " up: " + to_string(s->sent()) + " sent, " + to_string(s->dropped()) + " dropped");
+    r.wait_for(n);
+    expect(r.stop() == n, address + " up: " + to_string(r.lines()) + " of " + to_string(n) + " lines received");
+    log.remove_sink(s);
+}
+
+/*
+*   Receiver stopped after the first lines & started again: lines beyond max_pending meanwhile are dropped,
+*   the buffered rest follows on the new connection
+*/
+static void stopped(Logger& log, const string& address){
+    const uint64_t n = 20000, first = 100;
+    auto r1 = make_unique<receiver>(address);
+    auto s = attach(log, address, 16 << 10);
+    lines(log, 0, first);
+    s->flush();
+    r1->wait_for(first);
+    uint64_t got = r1->stop();
+    lines(log, first, n - first);                                                   ///> receiver gone: must not block
+    uint64_t dropped = s->dropped();
+    receiver r2(address);
+    bool settled = settle(*s, r2, n);
+    r2.wait_for(s->sent() - got);
+    got += r2.stop();
+    expect(dropped > 0, address + " stopped: " + to_string(dropped) + " lines dropped while no receiver");
+    expect(settled, address + " stopped: " + to_string(s->sent()) + " sent + " + to_string(s->dropped()) + " dropped = " + to_string(n));
+    expect(got == s->sent(), address + " stopped: " + to_string(got) + " lines received, " + to_string(s->sent()) + " sent");
+    log.remove_sink(s);
+}
+
+/*
+*   Receiver sleeping after every read: a burst overflows max_pending, the overflow is dropped, the rest arrives
+*/
+static void slow(Logger& log, const string& address){
+    const uint64_t n = 5000;
+    receiver r(address, 20);
+    auto s = attach(log, address, 8 << 10);
+    steady_clock::time_point t0 = steady_clock::now();
+    lines(log, 0, n);
+    double ms = duration<double, milli>(steady_clock::now() - t0).count();
+    bool settled = settle(*s, r, n);
+    r.wait_for(s->sent());
+    uint64_t got = r.stop();
+    expect(s->dropped() > 0, address + " slow: " + to_string(s->dropped()) + " lines dropped, burst took " + to_string(static_cast<int>(ms)) + "ms");
+    expect(settled, address + " slow: " + to_string(s->sent()) + " sent + " + to_string(s->dropped()) + " dropped = " + to_string(n));
+    expect(got == s->sent(), address + " slow: " + to_string(got) + " lines received, " + to_string(s->sent()) + " sent");
+    log.remove_sink(s);
+}
+
+int main(int argc, char** argv){
+    if (argc < 2){
+        fprintf(stderr, "usage: cpp_up_test_socket <path of cpp_up_logrecv>\n");
+        return 2;
+    }
+    g_recv = argv[1];
+    signal(SIGPIPE, SIG_IGN);
+    char dir[] = "/tmp/cpp_up_test_socket.XXXXXX";
+    if (!mkdtemp(dir)){
+        perror("mkdtemp");
+        return 2;
+    }
+
+    ostringstream unused;
+    Logger& log = Logger::get_instance(unused);
+    log.remove_sink(log.add_sink(unused));
+    log.set_log_level(LOG_DONE);
+
+    for (string kind : {"unix", "unixgram"}){
+        string path = string(dir) + "/" + kind + ".sock";
+        string address = kind + ":" + path;
+        delivered(log, address);
+        stopped(log, address);
+        slow(log, address);
+        unlink(path.c_str());
+    }
+    rmdir(dir);
+    if (!g_ok){
+        printf("FAILED: SocketSink lost lines or did not count them\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include <LogTrace.hpp>
+
+using namespace std;
+using namespace cpp_up;
+
+/*
+*   cpp_up_test_trace: the per-thread event limit keeps Chrome trace slices balanced
+*   - nested spans & instants past the limit: every kept "B" has its "E", no "E" without a "B", the limit holds
+*   - clear() with spans open: their "E" is dropped, later spans are balanced again
+*/
+
+static bool g_ok = true;
+
+static void expect(bool cond, const string& what){
+    printf("%-72s %s\n", what.c_str(), cond ? "ok" : "FAILED");
+    g_ok &= cond;
+}
+
+static void nest(uint32_t id, unsigned depth){
+    TraceSpan span(id);
+    LogTrace::instant(id);
+    if (depth > 1){
+        nest(id, depth - 1);
+        nest(id, depth - 1);
+    }
+}
+
+/*
+*   Export & check: depth never below 0 and back to 0 at the end, returns the event count
+*/
+static size_t check(const string& what, bool clear = false){
+    ostringstream out;
+    size_t n = LogTrace::write_json(out, clear);
+    string json = out.str();
+    long depth = 0;
+    bool balanced = true;
+    size_t b = 0;
+    for (size_t at = json.find("\"ph\":\""); at != string::npos; at = json.find("\"ph\":\"", at + 1)){
+        char ph = json[at + 6];
+        depth += ph == 'B' ? 1 : ph == 'E' ? -1 : 0;
+        b     += ph == 'B';
+        balanced &= depth >= 0;
+    }
+    balanced &= depth == 0;
+    expect(balanced, what + ": " + to_string(b) + " B / " + to_string(n) + " events, balanced");
+    return n;
+}
+
+int main(){
+    uint32_t id = LogTrace::intern("nest");
+    for (size_t limit : {2, 3, 7, 10, 50, 1000}){
+        LogTrace::set_enabled(true, limit);
+        LogTrace::clear();
+        nest(id, 6);                                                                ///> 63 spans, 63 instants
+        size_t n = check("limit " + to_string(limit));
+        expect(n <= limit && (limit >= 189 || LogTrace::dropped() > 0),
+               "limit " + to_string(limit) + ": " + to_string(n) + " kept, " + to_string(LogTrace::dropped()) + " dropped");
+    }
+
+    LogTrace::set_enabled(true, 1000);
+    LogTrace::clear();
+    {
+        TraceSpan outer(id);
+        nest(id, 3);
+        LogTrace::clear();                                                          ///> outer "B" gone, its "E" must not follow
+        nest(id, 3);
+    }
+    check("clear() inside a span");
+
+    LogTrace::set_enabled(false);
+    LogTrace::clear();
+    if (!g_ok){
+        printf("FAILED: unbalanced trace slices or limit exceeded\n");
+        return 1;
+    }
+    return 0;
+}
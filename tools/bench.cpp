@@ -0,0 +1,412 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <LogClock.hpp>
+#include <LogCompress.hpp>
+#include <LogProfile.hpp>
+#include <Logger.hpp>
+#include <ProgBar.hpp>
+#include <ProgSpin.hpp>
+#include <alloc_count.hpp>
+
+using namespace std;
+using namespace chrono;
+using namespace cpp_up;
+using namespace args;
+
+/*
+*   cpp_up_bench: ns/op, throughput & latency percentiles of the Logger, ProgBar and ProgSpin hot paths
+*     & of the LogCodec used for rotated files (one op = one 64 KB block)
+*   - every case runs twice per thread count: untimed loop for throughput, then every op timed for percentiles
+*   - output goes to /dev/null and to a regular file; -o writes the results as JSON for comparing runs
+*/
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Runner                                                                                                          //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct options{
+    uint64_t            ops                     {100000};                           ///> per thread & case
+    vector<unsigned>    threads;
+    string              filter;
+    string              json;
+    string              dir                     {"/tmp"};
+    bool                steady                  {false};
+};
+
+struct result{
+    string              group;
+    string              name;
+    string              target;
+    unsigned            threads;
+    uint64_t            ops;                                                        ///> all threads
+    double              ns_op;                                                      ///> wall time / ops
+    double              mops;
+    double              allocs_op;
+    LogHistogram::summary lat;                                                      ///> per op, timed pass
+};
+
+using op_fn = function<void(unsigned, uint64_t)>;                                   ///> (thread, iteration)
+
+/*
+*   Start all threads together, return wall ns of the slowest
+*/
+static uint64_t run_threads(unsigned n, const function<void(unsigned)>& body){
+    atomic<unsigned> ready {0};
+    atomic<bool> go {false};
+    vector<thread> th;
+    for (unsigned t = 0; t < n; ++t){
+        th.emplace_back([&, t]{
+            ready.fetch_add(1);
+            while (!go.load()){
+                this_thread::yield();
+            }
+            body(t);
+        });
+    }
+    while (ready.load() != n){
+        this_thread::yield();
+    }
+    uint64_t start = LogClock::now();
+    go.store(true);
+    for (thread& x : th){
+        x.join();
+    }
+    return LogClock::now() - start;
+}
+
+static result run_case(const options& o, const string& group, const string& name, const string& target,
+                       unsigned threads, const op_fn& op, const function<void()>& after = nullptr){
+    result r {group, name, target, threads, o.ops * threads, 0, 0, 0, {}};
+
+    ///> warm-up: caches, thread_local buffers, layouts
+    run_threads(threads, [&](unsigned t){
+        for (uint64_t i = 0; i < min<uint64_t>(o.ops / 10, 1000); ++i) op(t, i);
+    });
+    if (after) after();
+
+    uint64_t allocs = alloc_count();
+    uint64_t wall = run_threads(threads, [&](unsigned t){
+        for (uint64_t i = 0; i < o.ops; ++i) op(t, i);
+    });
+    if (after) after();
+    r.allocs_op = static_cast<double>(alloc_count() - allocs) / static_cast<double>(r.ops);
+    r.ns_op     = static_cast<double>(wall) / static_cast<double>(r.ops);
+    r.mops      = r.ns_op > 0 ? 1e3 / r.ns_op : 0;
+
+    vector<unique_ptr<LogHistogram>> hist;
+    for (unsigned t = 0; t < threads; ++t){
+        hist.emplace_back(new LogHistogram());
+    }
+    run_threads(threads, [&](unsigned t){
+        LogHistogram& h = *hist[t];
+        for (uint64_t i = 0; i < o.ops; ++i){
+            uint64_t a = LogClock::now();
+            op(t, i);
+            h.record(LogClock::elapsed(a, LogClock::now()));
+        }
+    });
+    if (after) after();
+    for (const unique_ptr<LogHistogram>& h : hist){
+        h->merge_into(r.lat);
+    }
+    return r;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Report                                                                                                          //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static void print_header(){
+    cout << left << setw(9) << "group" << setw(34) << "case" << setw(9) << "target" << right
+         << setw(4) << "thr" << setw(10) << "ns/op" << setw(9) << "Mops/s"
+         << setw(9) << "p50" << setw(9) << "p90" << setw(9) << "p99" << setw(9) << "p99.9" << setw(9) << "max"
+         << setw(11) << "allocs/op" << "\n";
+}
+
+static void print_result(const result& r){
+    auto dur = [](uint64_t ns){
+        string s;
+        log_append_ns(s, static_cast<double>(ns));
+        return s;
+    };
+    cout << left << setw(9) << r.group << setw(34) << r.name << setw(9) << r.target << right
+         << setw(4) << r.threads << setw(10) << fixed << setprecision(1) << r.ns_op << setw(9) << setprecision(2) << r.mops
+         << setw(9) << dur(r.lat.percentile(0.50)) << setw(9) << dur(r.lat.percentile(0.90))
+         << setw(9) << dur(r.lat.percentile(0.99)) << setw(9) << dur(r.lat.percentile(0.999)) << setw(9) << dur(r.lat.max)
+         << setw(11) << setprecision(3) << r.allocs_op << "\n" << flush;
+}
+
+static bool write_json(const string& path, const vector<result>& rs, const options& o){
+    ofstream f(path, ios::trunc);
+    if (!f){
+        return false;
+    }
+    f << "{\n  \"meta\": {\"ops_per_thread\": " << o.ops << ", \"hw_threads\": " << thread::hardware_concurrency()
+      << ", \"clock\": \"" << (LogClock::get_source() == LogClock::TSC ? "tsc" : "steady") << "\""
+      << ", \"clock_overhead_ns\": " << LogClock::overhead()
+#if defined(__clang__)
+      << ", \"compiler\": \"clang " << __clang_major__ << "." << __clang_minor__ << "\""
+#elif defined(__GNUC__)
+      << ", \"compiler\": \"gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "\""
+#endif
+      << ", \"cplusplus\": " << __cplusplus << "},\n  \"results\": [";
+    for (size_t i = 0; i < rs.size(); ++i){
+        const result& r = rs[i];
+        f << (i ? ",\n" : "\n") << "    {\"group\": \"" << r.group << "\", \"case\": \"" << r.name << "\", \"target\": \"" << r.target
+          << "\", \"threads\": " << r.threads << ", \"ops\": " << r.ops << fixed << setprecision(3)
+          << ", \"ns_per_op\": " << r.ns_op << ", \"mops\": " << r.mops << ", \"allocs_per_op\": " << r.allocs_op
+          << ", \"lat_ns\": {\"min\": " << (r.lat.count ? r.lat.min : 0) << ", \"mean\": " << r.lat.mean()
+          << ", \"p50\": " << r.lat.percentile(0.50) << ", \"p90\": " << r.lat.percentile(0.90)
+          << ", \"p99\": " << r.lat.percentile(0.99) << ", \"p999\": " << r.lat.percentile(0.999)
+          << ", \"max\": " << r.lat.max << "}}";
+    }
+    f << "\n  ]\n}\n";
+    return static_cast<bool>(f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Main                                                                                                            //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static void usage(){
+    cerr << "usage: cpp_up_bench [options]\n"
+            "   -n <N>      ops per thread & case         (default 100000)\n"
+            "   -t <list>   thread counts, e.g. 1,2,8     (default 1,2,4,hw)\n"
+            "   -f <str>    only cases containing str     (e.g. \"ProgBar\", \"c2 t1\")\n"
+            "   -o <file>   write results as JSON\n"
+            "   -d <dir>    directory of the file target  (default /tmp)\n"
+            "   --steady    time with steady_clock instead of the calibrated TSC\n";
+}
+
+int main(int argc, char** argv){
+    options o;
+    for (int i = 1; i < argc; ++i){
+        string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if      (a == "-n" && has_value) o.ops    = strtoull(argv[++i], nullptr, 10);
+        else if (a == "-f" && has_value) o.filter = argv[++i];
+        else if (a == "-o" && has_value) o.json   = argv[++i];
+        else if (a == "-d" && has_value) o.dir    = argv[++i];
+        else if (a == "--steady")        o.steady = true;
+        else if (a == "-t" && has_value){
+            stringstream ss(argv[++i]);
+            string n;
+            while (getline(ss, n, ',')){
+                o.threads.push_back(static_cast<unsigned>(max(1, atoi(n.c_str()))));
+            }
+        }
+        else{
+            usage();
+            return 2;
+        }
+    }
+    if (o.ops == 0){
+        usage();
+        return 2;
+    }
+    if (o.threads.empty()){
+        o.threads = {1, 2, 4, max(1u, thread::hardware_concurrency())};
+    }
+    sort(o.threads.begin(), o.threads.end());
+    o.threads.erase(unique(o.threads.begin(), o.threads.end()), o.threads.end());
+    if (!o.steady && !LogClock::set_source(LogClock::TSC)){
+        cerr << "cpp_up_bench: no invariant TSC, timing with steady_clock\n";
+    }
+
+    const string file_path = o.dir + "/cpp_up_bench.out";
+    ofstream devnull("/dev/null");
+    ofstream file(file_path, ios::trunc);
+    if (!devnull || !file){
+        cerr << "cpp_up_bench: cannot open /dev/null or " << file_path << "\n";
+        return 1;
+    }
+    struct target{
+        const char*     name;
+        ofstream&       out;
+    };
+    vector<target> targets {{"devnull", devnull}, {"file", file}};
+
+    vector<result> results;
+    auto selected = [&](const string& s){ return o.filter.empty() || s.find(o.filter) != string::npos; };
+    auto rewind = [](ostream& out){                                                 ///> keep the file target small
+        out.flush();
+        out.seekp(0);
+    };
+
+    cout << "cpp_up_bench: " << o.ops << " ops per thread & case, clock "
+         << (LogClock::get_source() == LogClock::TSC ? "tsc" : "steady") << " (overhead " << LogClock::overhead() << " ns subtracted)\n\n";
+    print_header();
+
+    ///> Logger: one instance per target, styles switched between cases
+    for (target& tg : targets){
+        Logger log(tg.out);
+        auto after = [&]{ log.flush(); rewind(tg.out); };
+
+        string name = "log(...) disabled";
+        if (selected("Logger " + name)){
+            log.set_log_level(LOG_INFO);
+            for (unsigned th : o.threads){
+                results.push_back(run_case(o, "Logger", name, tg.name, th, [&](unsigned, uint64_t i){
+                    log(LOG_DEBUG) << "bench message " << i << ' ' << 3.25;
+                }, after));
+                print_result(results.back());
+            }
+        }
+        log.set_log_level(LOG_DEBUG);
+        for (unsigned c = LOG_COLORS_NONE; c <= LOG_COLORS_UNDERLINE; ++c){
+            for (unsigned t = 0; t < 2; ++t){
+                for (unsigned s = 0; s < 2; ++s){
+                    name = "log(...) c" + to_string(c) + " t" + to_string(t) + " s" + to_string(s);
+                    if (!selected("Logger " + name)){
+                        continue;
+                    }
+                    log.set_log_style_colors(c);
+                    log.set_log_style_time(t);
+                    log.set_log_style_status(s);
+                    for (unsigned th : o.threads){
+                        results.push_back(run_case(o, "Logger", name, tg.name, th, [&](unsigned, uint64_t i){
+                            log(LOG_INFO) << "bench message " << i << ' ' << 3.25;
+                        }, after));
+                        print_result(results.back());
+                    }
+                }
+            }
+        }
+        log.set_log_style_colors(LOG_COLORS_NONE);
+        log.set_log_style_time(false);
+        log.set_log_style_status(false);
+        log.set_log_coalesce(milliseconds(100));
+        for (bool same : {true, false}){
+            name = same ? "log(...) coalesce repeat" : "log(...) coalesce distinct";
+            if (!selected("Logger " + name)){
+                continue;
+            }
+            for (unsigned th : o.threads){
+                results.push_back(run_case(o, "Logger", name, tg.name, th, [&](unsigned, uint64_t i){
+                    log(LOG_INFO) << "bench message " << (same ? 0 : i) << ' ' << 3.25;
+                }, after));
+                print_result(results.back());
+            }
+        }
+        log.set_log_coalesce(milliseconds(0));
+        for (unsigned f : {LOG_FORMAT_TEXT, LOG_FORMAT_JSON}){
+            log.set_log_format(f);
+            for (bool kv : {false, true}){
+                name = string("log(...) ") + (f == LOG_FORMAT_JSON ? "json" : "text") + (kv ? " kv" : "");
+                if (!selected("Logger " + name)){
+                    continue;
+                }
+                for (unsigned th : o.threads){
+                    results.push_back(run_case(o, "Logger", name, tg.name, th, [&](unsigned, uint64_t i){
+                        if (kv){
+                            log(LOG_INFO) << "bench message" << log_kv("i", i) << log_kv("v", 3.25) << log_kv("user", "alice");
+                        }
+                        else{
+                            log(LOG_INFO) << "bench message " << i << ' ' << 3.25;
+                        }
+                    }, after));
+                    print_result(results.back());
+                }
+            }
+        }
+        log.set_log_format(LOG_FORMAT_TEXT);
+    }
+
+    ///> ProgBar / ProgSpin: single-threaded by design
+    for (target& tg : targets){
+        if (selected("ProgBar operator++")){
+            ProgBar<uint64_t> bar(tg.out, UINT64_MAX);
+            results.push_back(run_case(o, "ProgBar", "operator++", tg.name, 1, [&](unsigned, uint64_t){ ++bar; },
+                                       [&]{ rewind(tg.out); }));
+            print_result(results.back());
+        }
+        if (selected("ProgBar operator++ poll 0ms")){
+            ProgBar<uint64_t> bar(tg.out, UINT64_MAX, 0);
+            results.push_back(run_case(o, "ProgBar", "operator++ poll 0ms", tg.name, 1, [&](unsigned, uint64_t){ ++bar; },
+                                       [&]{ rewind(tg.out); }));
+            print_result(results.back());
+        }
+        if (selected("ProgBar check()")){
+            ProgBar<uint64_t> bar(tg.out, UINT64_MAX);
+            results.push_back(run_case(o, "ProgBar", "check()", tg.name, 1, [&](unsigned, uint64_t){ bar.check(); },
+                                       [&]{ rewind(tg.out); }));
+            print_result(results.back());
+        }
+        if (selected("ProgSpin update()")){
+            ProgSpin ps {tg.out};
+            ps.set_style(PS_STYLE_SQUARE);
+            ps.process(UINT64_MAX);
+            results.push_back(run_case(o, "ProgSpin", "update()", tg.name, 1, [&](unsigned, uint64_t){ ps.update(); },
+                                       [&]{ rewind(tg.out); }));
+            print_result(results.back());
+        }
+    }
+
+    ///> LogCodec: 64 KB blocks of varied log lines & of random bytes, in memory
+    {
+        const size_t blk = 64 << 10, nblk = 16;
+        mt19937 gen(1);
+        auto rng = [&]{ return static_cast<unsigned>(gen()); };
+        string lines, noise(blk * nblk, '\0');
+        static const char* paths[] {"/api/v1/items", "/api/v1/users", "/health", "/api/v2/orders"};
+        char line[256];
+        while (lines.size() < blk * nblk){
+            int len = snprintf(line, sizeof(line), "2026-10-17 14:36:%02u.%06u [INFO ] %u request id=%08x path=%s/%u took %uus status=%u\n",
+                               rng() % 60, rng() % 1000000, 4000 + rng() % 8, rng(), paths[rng() % 4], rng() % 10000, rng() % 5000,
+                               rng() % 8 ? 200 : 500);
+            lines.append(line, static_cast<size_t>(len));
+        }
+        for (char& c : noise){
+            c = static_cast<char>(rng());
+        }
+        options co = o;
+        co.ops = max<uint64_t>(1, o.ops / 100);                                     ///> a block takes ~100x a log line
+        for (const auto& data : {make_pair("log lines", &lines), make_pair("random", &noise)}){
+            vector<vector<char>> packed(nblk, vector<char>(LogCodec::bound(blk)));
+            vector<size_t> sizes(nblk);
+            size_t total = 0;
+            for (size_t b = 0; b < nblk; ++b){
+                sizes[b] = LogCodec::compress(data.second->data() + b * blk, blk, packed[b].data());
+                total += sizes[b];
+            }
+            ostringstream ratio;
+            ratio << fixed << setprecision(2) << static_cast<double>(blk * nblk) / static_cast<double>(total) << "x";
+            string name = string("compress 64KB ") + data.first + " " + ratio.str();
+            if (selected("LogCodec " + name)){
+                vector<char> dst(LogCodec::bound(blk));
+                results.push_back(run_case(co, "LogCodec", name, "memory", 1, [&](unsigned, uint64_t i){
+                    LogCodec::compress(data.second->data() + i % nblk * blk, blk, dst.data());
+                }));
+                print_result(results.back());
+            }
+            name = string("decompress 64KB ") + data.first;
+            if (selected("LogCodec " + name)){
+                string raw(blk, '\0');
+                results.push_back(run_case(co, "LogCodec", name, "memory", 1, [&](unsigned, uint64_t i){
+                    LogCodec::decompress(packed[i % nblk].data(), sizes[i % nblk], &raw[0], blk);
+                }));
+                print_result(results.back());
+            }
+        }
+    }
+
+    file.close();
+    remove(file_path.c_str());
+    if (!o.json.empty() && !write_json(o.json, results, o)){
+        cerr << "cpp_up_bench: cannot write " << o.json << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include <LogBinary.hpp>
+#include <LogLayout.hpp>
+#include <Logger.hpp>
+
+using namespace std;
+using namespace chrono;
+using namespace cpp_up;
+using namespace args;
+
+/*
+*   cpp_up_logdecode: turn a binary log stream (Logger::set_log_binary_path) back into the text Logger prints
+*   - lines of all threads are merged by time
+*   - style options mirror the set_log_style_* calls of the logging program
+*/
+static void usage(){
+    cerr << "usage: cpp_up_logdecode [options] <in.bin> [out.txt]\n"
+            "   -t          time module                 (set_log_style_time)\n"
+            "   -s          status module               (set_log_style_status)\n"
+            "   -c <N>      color style 0..4            (set_log_style_colors)\n"
+            "   -P <N>      time precision 0..2         (set_log_style_time_precision)\n"
+            "   -F <N>      time format 0..3            (set_log_style_time_format)\n"
+            "   -p <str>    line pattern                (set_log_pattern)\n"
+            "   file & line (%s %# %@) come from LOG_MSG / LOG_CAT or log(level, __FILE__, __LINE__); plain log(level) has none\n";
+}
+
+int main(int argc, char** argv){
+    bool f_time = false, f_stat = false;
+    unsigned color = LOG_COLORS_NONE, prec = LOG_TIME_SEC, fmt = LOG_TIME_LOCAL;
+    string pattern, in_path, out_path;
+
+    for (int i = 1; i < argc; ++i){
+        string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if      (a == "-t") f_time = true;
+        else if (a == "-s") f_stat = true;
+        else if (a == "-c" && has_value) color   = static_cast<unsigned>(atoi(argv[++i]));
+        else if (a == "-P" && has_value) prec    = static_cast<unsigned>(atoi(argv[++i]));
+        else if (a == "-F" && has_value) fmt     = static_cast<unsigned>(atoi(argv[++i]));
+        else if (a == "-p" && has_value) pattern = argv[++i];
+        else if (a[0] != '-' && in_path.empty())  in_path  = a;
+        else if (a[0] != '-' && out_path.empty()) out_path = a;
+        else{
+            usage();
+            return 2;
+        }
+    }
+    if (in_path.empty()){
+        usage();
+        return 2;
+    }
+
+    ifstream in(in_path, ios::binary);
+    if (!in){
+        cerr << "cpp_up_logdecode: cannot open " << in_path << "\n";
+        return 1;
+    }
+    string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    LogBinary::decoded d;
+    bool complete = LogBinary::decode(bytes, d);
+    stable_sort(d.entries.begin(), d.entries.end(), [](const LogBinary::decoded::entry& a, const LogBinary::decoded::entry& b){
+        return a.ns < b.ns;
+    });
+
+    ofstream out_file;
+    if (!out_path.empty()){
+        out_file.open(out_path, ios::binary);
+        if (!out_file){
+            cerr << "cpp_up_logdecode: cannot create " << out_path << "\n";
+            return 1;
+        }
+    }
+    Logger log(out_path.empty() ? cout : out_file);
+    log.set_log_style_colors(color);
+    log.set_log_style_time(f_time);
+    log.set_log_style_status(f_stat);
+    log.set_log_style_time_precision(prec);
+    log.set_log_style_time_format(fmt);
+    log.set_log_pattern(pattern);
+
+    for (const LogBinary::decoded::entry& e : d.entries){
+        const char* file = nullptr;
+        unsigned line    = 0;
+        if (e.site != 0 && e.site <= d.sites.size() && !d.sites[e.site - 1].first.empty()){
+            file = d.sites[e.site - 1].first.c_str();
+            line = d.sites[e.site - 1].second;
+        }
+        log.log_record({e.level, system_clock::time_point(duration_cast<system_clock::duration>(nanoseconds(e.ns))),
+                        file, line, e.body, e.tid});
+    }
+    log.flush();
+
+    if (!complete){
+        cerr << "cpp_up_logdecode: stream is truncated or damaged, decoded " << d.entries.size() << " lines\n";
+        return 1;
+    }
+    return 0;
+}
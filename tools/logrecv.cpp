@@ -0,0 +1,147 @@
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <LogSocket.hpp>
+
+using namespace std;
+using namespace chrono;
+using namespace cpp_up;
+
+/*
+*   cpp_up_logrecv: stand-in collector for SocketSink (Logger::set_log_socket) - prints the received lines
+*   - same addresses as the sink; stream sockets accept any number of connections
+*   - -d slows it down to watch the sink buffer, drop & count instead of blocking the logging program
+*/
+static void usage(){
+    cerr << "usage: cpp_up_logrecv [options] <address>\n"
+            "   -n <N>      exit after N lines\n"
+            "   -d <ms>     sleep after every read (slow collector)\n"
+            "   -q          count only, do not print lines\n"
+            "   -s          print lines, reads & bytes received to stderr at exit\n"
+            "   address     unix:/path, unixgram:/path, tcp:host:port, udp:host:port\n";
+}
+
+static volatile sig_atomic_t g_stop = 0;
+
+struct stats{
+    uint64_t            lines                   {0};
+    uint64_t            reads                   {0};
+    uint64_t            bytes                   {0};
+    uint64_t            cut                     {0};                                ///> incomplete frames (connection closed, bad datagram)
+};
+
+/*
+*   Print the complete frames at the start of buf, return the bytes consumed
+*/
+static size_t consume(const char* p, size_t n, bool quiet, stats& st){
+    size_t at = 0;
+    while (n - at >= 4){
+        const unsigned char* h = reinterpret_cast<const unsigned char*>(p + at);
+        size_t len = h[0] | h[1] << 8 | h[2] << 16 | static_cast<size_t>(h[3]) << 24;
+        if (n - at - 4 < len){
+            break;
+        }
+        if (!quiet){
+            fwrite(p + at + 4, 1, len, stdout);
+            fputc('\n', stdout);
+        }
+        ++st.lines;
+        at += 4 + len;
+    }
+    return at;
+}
+
+int main(int argc, char** argv){
+    uint64_t max_lines = 0;
+    int delay = 0;
+    bool quiet = false, summary = false;
+    string address;
+
+    for (int i = 1; i < argc; ++i){
+        string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if      (a == "-n" && has_value) max_lines = strtoull(argv[++i], nullptr, 10);
+        else if (a == "-d" && has_value) delay     = atoi(argv[++i]);
+        else if (a == "-q") quiet   = true;
+        else if (a == "-s") summary = true;
+        else if (a[0] != '-' && address.empty()) address = a;
+        else{
+            usage();
+            return 2;
+        }
+    }
+    if (address.empty()){
+        usage();
+        return 2;
+    }
+    int lfd = SocketSink::listen_socket(address);
+    if (lfd < 0){
+        cerr << "cpp_up_logrecv: cannot listen on " << address << "\n";
+        return 1;
+    }
+    signal(SIGINT,  [](int){ g_stop = 1; });
+    signal(SIGTERM, [](int){ g_stop = 1; });
+
+    bool stream = SocketSink::is_stream(address);
+    vector<pollfd> fds {{lfd, POLLIN, 0}};
+    vector<string> pending {""};                                                    ///> per connection: bytes of an incomplete frame
+    vector<char> buf(1 << 16);
+    stats st;
+    while (!g_stop && (max_lines == 0 || st.lines < max_lines)){
+        if (poll(fds.data(), fds.size(), 200) <= 0){
+            fflush(stdout);
+            continue;
+        }
+        if (stream && (fds[0].revents & POLLIN)){
+            int c = accept(lfd, nullptr, nullptr);
+            if (c >= 0){
+                fds.push_back({c, POLLIN, 0});
+                pending.emplace_back();
+            }
+        }
+        for (size_t i = stream ? 1 : 0; i < fds.size(); ++i){
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))){
+                continue;
+            }
+            ssize_t r = recv(fds[i].fd, buf.data(), buf.size(), 0);
+            if (r > 0){
+                ++st.reads;
+                st.bytes += static_cast<uint64_t>(r);
+                if (!stream){
+                    st.cut += consume(buf.data(), static_cast<size_t>(r), quiet, st) != static_cast<size_t>(r);
+                }
+                else{
+                    string& rest = pending[i];
+                    rest.append(buf.data(), static_cast<size_t>(r));
+                    rest.erase(0, consume(rest.data(), rest.size(), quiet, st));
+                }
+                if (delay > 0){
+                    this_thread::sleep_for(milliseconds(delay));
+                }
+            }
+            else if (stream && r == 0){
+                st.cut += !pending[i].empty();                                      ///> connection closed mid-frame
+                ::close(fds[i].fd);
+                fds.erase(fds.begin() + static_cast<long>(i));
+                pending.erase(pending.begin() + static_cast<long>(i));
+                --i;
+            }
+        }
+    }
+    fflush(stdout);
+    if (summary){
+        fprintf(stderr, "%llu lines, %llu reads, %llu bytes, %llu cut frames\n", static_cast<unsigned long long>(st.lines),
+                static_cast<unsigned long long>(st.reads), static_cast<unsigned long long>(st.bytes), static_cast<unsigned long long>(st.cut));
+    }
+    return 0;
+}
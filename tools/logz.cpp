@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include <LogCompress.hpp>
+
+using namespace std;
+using namespace chrono;
+using namespace cpp_up;
+
+/*
+*   cpp_up_logz: decompress rotated log files written with Logger::set_log_file_compression ('log.txt.1.cpz')
+*   - streams block by block, '-' or no path means stdin/stdout: cpp_up_logz log.txt.1.cpz | grep ERROR
+*   - -c compresses into the same frame format (e.g. for logs rotated without compression)
+*/
+static void usage(){
+    cerr << "usage: cpp_up_logz [options] [in|-] [out|-]\n"
+            "   -c          compress instead of decompress\n"
+            "   -v          print sizes, ratio & speed to stderr\n";
+}
+
+int main(int argc, char** argv){
+    bool pack = false, verbose = false;
+    string in_path, out_path;
+
+    for (int i = 1; i < argc; ++i){
+        string a = argv[i];
+        if      (a == "-c") pack    = true;
+        else if (a == "-v") verbose = true;
+        else if ((a == "-" || a[0] != '-') && in_path.empty())  in_path  = a;
+        else if ((a == "-" || a[0] != '-') && out_path.empty()) out_path = a;
+        else{
+            usage();
+            return 2;
+        }
+    }
+
+    FILE* in  = in_path.empty() || in_path == "-" ? stdin : fopen(in_path.c_str(), "rb");
+    if (!in){
+        cerr << "cpp_up_logz: cannot open " << in_path << "\n";
+        return 1;
+    }
+    FILE* out = out_path.empty() || out_path == "-" ? stdout : fopen(out_path.c_str(), "wb");
+    if (!out){
+        cerr << "cpp_up_logz: cannot create " << out_path << "\n";
+        return 1;
+    }
+
+    auto t0 = steady_clock::now();
+    bool ok = pack ? LogCodec::compress_file(in, out) : LogCodec::decompress_file(in, out);
+    double sec = duration<double>(steady_clock::now() - t0).count();
+    long in_bytes  = ftell(in);
+    ok = fflush(out) == 0 && ok;
+    long out_bytes = ftell(out);
+    if (in != stdin){
+        fclose(in);
+    }
+    if (out != stdout && fclose(out) != 0){
+        ok = false;
+    }
+
+    if (!ok){
+        cerr << "cpp_up_logz: " << (pack ? "compression failed" : "input is truncated or damaged") << "\n";
+        return 1;
+    }
+    if (verbose && in_bytes > 0 && out_bytes > 0){
+        long raw = pack ? in_bytes : out_bytes;
+        long cpz = pack ? out_bytes : in_bytes;
+        fprintf(stderr, "%ld -> %ld bytes, ratio %.2f, %.0f MB/s\n", in_bytes, out_bytes,
+                static_cast<double>(raw) / static_cast<double>(cpz), static_cast<double>(raw) / 1e6 / (sec > 0 ? sec : 1e-9));
+    }
+    return 0;
+}
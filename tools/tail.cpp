@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <LogCategory.hpp>
+#include <LogShm.hpp>
+
+using namespace std;
+using namespace chrono;
+using namespace cpp_up;
+
+/*
+*   cpp_up_tail: print the lines a running program publishes with Logger::set_log_shm_name (or a ShmSink)
+*   - read-only mapping of the ring: attaching, following or detaching never slows the producer down
+*   - polls while idle (100us, then 1ms); lines the producer overwrote before they were read are reported on stderr
+*/
+static void usage(){
+    cerr << "usage: cpp_up_tail [options] <name>\n"
+            "   -f          follow: wait for new lines, reattach when the producer recreates the ring\n"
+            "   -n          new lines only (default: start with every line still in the ring)\n"
+            "   -l <level>  most verbose level shown: err, warn, info, time, done, debug or 0..5\n";
+}
+
+int main(int argc, char** argv){
+    bool follow = false, fresh = false;
+    unsigned max_level = 5;
+    string name;
+
+    for (int i = 1; i < argc; ++i){
+        string a = argv[i];
+        if      (a == "-f") follow = true;
+        else if (a == "-n") fresh  = true;
+        else if (a == "-l" && i + 1 < argc && LogCategory::parse_level(argv[i + 1], max_level)) ++i;
+        else if (a[0] != '-' && name.empty()) name = a;
+        else{
+            usage();
+            return 2;
+        }
+    }
+    if (name.empty()){
+        usage();
+        return 2;
+    }
+
+    unique_ptr<ShmReader> rd = make_unique<ShmReader>(name, !fresh);
+    if (!rd->is_open()){
+        if (!follow){
+            cerr << "cpp_up_tail: no ring " << ShmSink::shm_name(name) << "\n";
+            return 1;
+        }
+        cerr << "cpp_up_tail: waiting for " << ShmSink::shm_name(name) << "\n";
+    }
+
+    string line;
+    unsigned ll = 0;
+    uint64_t lost = 0;
+    unsigned idle = 0;
+    for (;;){
+        if (rd->next(line, ll)){
+            idle = 0;
+            if (ll <= max_level){
+                fwrite(line.data(), 1, line.size(), stdout);
+            }
+            if (rd->lost() != lost){
+                fflush(stdout);
+                fprintf(stderr, "cpp_up_tail: %llu lines lost (overwritten before read)\n", static_cast<unsigned long long>(rd->lost() - lost));
+                lost = rd->lost();
+            }
+            continue;
+        }
+        if (fflush(stdout) != 0){
+            return 1;                                                               ///> reader of our output is gone
+        }
+        if (!follow){
+            break;
+        }
+        if (++idle % 1000 == 0 && rd->replaced()){
+            rd   = make_unique<ShmReader>(name, true);
+            lost = 0;
+        }
+        this_thread::sleep_for(idle < 100 ? microseconds(100) : microseconds(1000));
+    }
+    return 0;
+}